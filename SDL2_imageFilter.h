@@ -35,6 +35,8 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 extern "C" {
 #endif
 
+#include "SDL.h"
+
 	/* ---- Function Prototypes */
 
 #ifdef _MSC_VER
@@ -53,15 +55,63 @@ extern "C" {
 	/* Comments:                                                                           */
 	/*  1.) MMX functions work best if all data blocks are aligned on a 32 bytes boundary. */
 	/*  2.) Data that is not within an 8 byte boundary is processed using the C routine.   */
-	/*  3.) Convolution routines do not have C routines at this time.                      */
-
-	// Detect MMX capability in CPU
+	/*  3.) Convolution kernels are passed with each row padded to 4 (3x3), 8 (5x5, 7x7)   */
+	/*      or 12 (9x9) words; the C routines produce the same results as the MMX code.    */
+	/*  4.) Element-wise routines use SSE2 or AVX2 (selected at runtime) when available;   */
+	/*      data that is not within a 16 byte boundary is then processed by the C routine. */
+
+	// Operations of a fused pipeline (see SDL_imageFilterPipelineAdd)
+#define SDL_IMAGEFILTER_OP_BITNEGATION				1	// no arguments
+#define SDL_IMAGEFILTER_OP_ADDBYTE					2	// C
+#define SDL_IMAGEFILTER_OP_ADDBYTETOHALF			3	// C
+#define SDL_IMAGEFILTER_OP_SUBBYTE					4	// C
+#define SDL_IMAGEFILTER_OP_SHIFTRIGHT				5	// N
+#define SDL_IMAGEFILTER_OP_MULTBYBYTE				6	// C
+#define SDL_IMAGEFILTER_OP_SHIFTRIGHTANDMULTBYBYTE	7	// N, C
+#define SDL_IMAGEFILTER_OP_SHIFTLEFTBYTE			8	// N
+#define SDL_IMAGEFILTER_OP_SHIFTLEFT				9	// N
+#define SDL_IMAGEFILTER_OP_BINARIZEUSINGTHRESHOLD	10	// T
+#define SDL_IMAGEFILTER_OP_CLIPTORANGE				11	// Tmin, Tmax
+#define SDL_IMAGEFILTER_OP_NORMALIZELINEAR			12	// Cmin, Cmax, Nmin, Nmax
+
+	// Norms of the gradient magnitude of SDL_imageFilterSobel
+#define SDL_IMAGEFILTER_SOBEL_L1		0	// |Gx| + |Gy|
+#define SDL_IMAGEFILTER_SOBEL_L2		1	// sqrt(Gx^2 + Gy^2), approximated within 4%
+
+	// Gradient directions of SDL_imageFilterSobel (rows pointing down)
+#define SDL_IMAGEFILTER_DIRECTION_0		0	// horizontal, also for zero gradients
+#define SDL_IMAGEFILTER_DIRECTION_45	1	// Gx and Gy of the same sign
+#define SDL_IMAGEFILTER_DIRECTION_90	2	// vertical
+#define SDL_IMAGEFILTER_DIRECTION_135	3	// Gx and Gy of opposite signs
+
+	// Flags of SDL_imageFilterSurfaceOp
+#define SDL_IMAGEFILTER_PRESERVE_ALPHA	1	// copy the alpha channel unchanged
+
+	// Opaque fused pipeline of element-wise operations
+	typedef struct SDL_imageFilterPipeline SDL_imageFilterPipeline;
+
+	// Strided 2D image: height rows of width bytes, pitch bytes apart
+	typedef struct {
+		unsigned char *pixels;
+		int pitch;
+		int width;
+		int height;
+	} SDL_imageFilterImage;
+
+	// Element-wise filter with two sources (SDL_imageFilterAdd, SDL_imageFilterMean, ...)
+	typedef int (*SDL_imageFilterBinaryFunction)(unsigned char *Src1, unsigned char *Src2, unsigned char *Dest, unsigned int length);
+
+	// Detect MMX (or SSE2/AVX2) capability in CPU
 	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterMMXdetect(void);
 
-	// Force use of MMX off (or turn possible use back on)
+	// Force use of MMX, SSE2 and AVX2 off (or turn possible use back on)
 	SDL2_IMAGEFILTER_SCOPE void SDL_imageFilterMMXoff(void);
 	SDL2_IMAGEFILTER_SCOPE void SDL_imageFilterMMXon(void);
 
+	// Split large images across numThreads threads (0: one per CPU core, 1: off, the default)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSetThreads(int numThreads);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterGetThreads(void);
+
 	//
 	// All routines return:
 	//   0   OK
@@ -154,10 +204,118 @@ extern "C" {
 	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterClipToRange(unsigned char *Src1, unsigned char *Dest, unsigned int length,
 		unsigned char Tmin, unsigned char Tmax);
 
-	//  SDL_imageFilterNormalizeLinear: D = saturation255((Nmax - Nmin)/(Cmax - Cmin)*(S - Cmin) + Nmin)
+	//  SDL_imageFilterNormalizeLinear: D = saturation0and255((Nmax - Nmin)/(Cmax - Cmin)*(S - Cmin) + Nmin), 8.16 fixed point
 	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterNormalizeLinear(unsigned char *Src, unsigned char *Dest, unsigned int length, int Cmin,
 		int Cmax, int Nmin, int Nmax);
 
+	//  SDL_imageFilterNormalizeAuto: D = saturation255((Nmax - Nmin)/(max(S) - min(S))*(S - min(S)) + Nmin)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterNormalizeAuto(unsigned char *Src, unsigned char *Dest, unsigned int length,
+		int Nmin, int Nmax);
+
+	// Statistics
+
+	//  SDL_imageFilterHistogram: H[k] = number of bytes of value k (256 counts)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterHistogram(unsigned char *Src, unsigned int length, unsigned int *Histogram);
+
+	//  SDL_imageFilterMinMax: smallest and largest byte
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterMinMax(unsigned char *Src, unsigned int length, unsigned char *Min,
+		unsigned char *Max);
+
+	//  SDL_imageFilterSum: sum of the bytes
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSum(unsigned char *Src, unsigned int length, Uint64 *Sum);
+
+	//  SDL_imageFilterMeanVariance: mean and population variance of the bytes
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterMeanVariance(unsigned char *Src, unsigned int length, double *Mean,
+		double *Variance);
+
+	//  SDL_imageFilterConvolveKernel3x3Divide: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel3x3Divide(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char Divisor);
+
+	//  SDL_imageFilterConvolveKernel5x5Divide: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel5x5Divide(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char Divisor);
+
+	//  SDL_imageFilterConvolveKernel7x7Divide: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel7x7Divide(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char Divisor);
+
+	//  SDL_imageFilterConvolveKernel9x9Divide: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel9x9Divide(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char Divisor);
+
+	//  SDL_imageFilterConvolveKernel3x3ShiftRight: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel3x3ShiftRight(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char NRightShift);
+
+	//  SDL_imageFilterConvolveKernel5x5ShiftRight: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel5x5ShiftRight(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char NRightShift);
+
+	//  SDL_imageFilterConvolveKernel7x7ShiftRight: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel7x7ShiftRight(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char NRightShift);
+
+	//  SDL_imageFilterConvolveKernel9x9ShiftRight: Dij = saturation0and255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel9x9ShiftRight(unsigned char *Src, unsigned char *Dest, int rows,
+		int columns, signed short *Kernel, unsigned char NRightShift);
+
+	//  SDL_imageFilterSobelX: Dij = saturation255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSobelX(unsigned char *Src, unsigned char *Dest, int rows, int columns);
+
+	//  SDL_imageFilterSobelXShiftRight: Dij = saturation255( ... )
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSobelXShiftRight(unsigned char *Src, unsigned char *Dest, int rows, int columns,
+		unsigned char NRightShift);
+
+	//  SDL_imageFilterSobel: Dij = saturation255( norm(Gx, Gy) >> N ), optionally with the gradient direction
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSobel(unsigned char *Src, unsigned char *Dest, unsigned char *Direction,
+		int rows, int columns, int norm, unsigned char NRightShift);
+
+	//  SDL_imageFilterConvolveSeparable: Dij = saturation0and255( (sum(Cm * sum(Rn * S(i+m,j+n))) + round) >> N ) (sum(|Cm|) * sum(|Rn|) * 255 < 2^31)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveSeparable(unsigned char *Src, unsigned char *Dest, int rows, int columns,
+		signed short *RowKernel, signed short *ColumnKernel, int size, unsigned char NRightShift);
+
+	//  SDL_imageFilterGaussianBlur: separable Gaussian of odd size (sigma <= 0: derived from size)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterGaussianBlur(unsigned char *Src, unsigned char *Dest, int rows, int columns,
+		int size, double sigma);
+
+	//  SDL_imageFilterBoxBlur: Dij = mean of S over the (2*radius+1)^2 window, in constant time per pixel
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterBoxBlur(unsigned char *Src, unsigned char *Dest, int rows, int columns, int radius);
+
+	//  SDL_imageFilterIntegralImage: Dyx = sum of S above and left of (x,y), (rows+1)x(columns+1) entries
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterIntegralImage(unsigned char *Src, int Srcpitch, unsigned int *Dest, int rows, int columns);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterIntegralSum(unsigned int *Integral, int rows, int columns, const SDL_Rect *rect,
+		unsigned int *Sum);
+
+	//  Pipelines: apply a list of element-wise operations in one pass over cache-sized chunks
+	SDL2_IMAGEFILTER_SCOPE SDL_imageFilterPipeline *SDL_imageFilterPipelineCreate(void);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterPipelineAdd(SDL_imageFilterPipeline *pipeline, int op, int arg1, int arg2,
+		int arg3, int arg4);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterPipelineRun(SDL_imageFilterPipeline *pipeline, unsigned char *Src,
+		unsigned char *Dest, unsigned int length);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterPipelineLUT(SDL_imageFilterPipeline *pipeline, unsigned char *LUT);
+	SDL2_IMAGEFILTER_SCOPE void SDL_imageFilterPipelineFree(SDL_imageFilterPipeline *pipeline);
+
+	//  SDL_imageFilterLUT: D = LUT[S] (256 byte lookup table)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterLUT(unsigned char *Src, unsigned char *Dest, unsigned int length,
+		const unsigned char *LUT);
+
+	//  Strided 2D variants: filter a rectangle (NULL: all) of images with padded rows in place
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterBinary2D(SDL_imageFilterBinaryFunction filter, const SDL_imageFilterImage *Src1,
+		const SDL_imageFilterImage *Src2, const SDL_imageFilterImage *Dest, const SDL_Rect *rect);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterPipelineRun2D(SDL_imageFilterPipeline *pipeline, const SDL_imageFilterImage *Src,
+		const SDL_imageFilterImage *Dest, const SDL_Rect *rect);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterConvolveKernel2D(const SDL_imageFilterImage *Src, const SDL_imageFilterImage *Dest,
+		const SDL_Rect *rect, signed short *Kernel, int size, unsigned char Divisor, unsigned char NRightShift);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSobelX2D(const SDL_imageFilterImage *Src, const SDL_imageFilterImage *Dest,
+		const SDL_Rect *rect, unsigned char NRightShift);
+
+	//  Surface filters: filter the R, G, B and A channels of 32 bit surfaces (located by the format masks)
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSurfaceOp(SDL_Surface *Src, SDL_Surface *Dest, int op, unsigned char Cr,
+		unsigned char Cg, unsigned char Cb, unsigned char Ca, int flags);
+	SDL2_IMAGEFILTER_SCOPE int SDL_imageFilterSurfaceLUT(SDL_Surface *Src, SDL_Surface *Dest, const unsigned char *LUTr,
+		const unsigned char *LUTg, const unsigned char *LUTb, const unsigned char *LUTa);
+
 	/* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
@@ -1,6 +1,6 @@
 /*  
 
-SDL2_rotozoom.c: rotozoomer, zoomer and shrinker for 32bit or 8bit surfaces
+SDL2_rotozoom.c: rotozoomer, zoomer and shrinker for 32bit, 24bit, 16bit or 8bit surfaces
 
 Copyright (C) 2012-2014  Andreas Schiffler
 
@@ -36,6 +36,12 @@ Andreas Schiffler -- aschiffler at ferzkopp dot net
 
 #include "SDL2_rotozoom.h"
 
+/* Use SSE2 intrinsics if the compiler targets SSE2 (always the case on x86_64) */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#  include <emmintrin.h>
+#  define USE_SSE2_ROTOZOOM
+#endif
+
 /* ---- Internally used structures */
 
 /*!
@@ -60,6 +66,11 @@ typedef struct tColorY {
 */
 #define MAX(a,b)    (((a) > (b)) ? (a) : (b))
 
+/*! 
+\brief Returns minimum of two numbers a and b.
+*/
+#define MIN(a,b)    (((a) < (b)) ? (a) : (b))
+
 /*! 
 \brief Number of guard rows added to destination surfaces.
 
@@ -77,6 +88,20 @@ to a situation where the program can segfault.
 */
 #define VALUE_LIMIT	0.001
 
+/*!
+\brief Edge length of the square destination tiles scanned by the rotozoomer.
+
+The destination surface is processed in tiles of this size so that the source
+pixels read by neighboring destination pixels stay within a small working set,
+even for rotation angles close to 90 degrees.
+*/
+#define TRANSFORM_TILE_SIZE 32
+
+/*!
+\brief Edge length of the square source tiles transposed by the 90 degree rotator.
+*/
+#define ROTATE90_TILE_SIZE 32
+
 /*!
 \brief Returns colorkey info for a surface
 */
@@ -88,6 +113,188 @@ Uint32 _colorkey(SDL_Surface *src)
 }
 
 
+/*!
+\brief Internal helper for smoothing flags with premultiplied interpolation modes.
+*/
+#define SMOOTHING_PREMULTIPLIED_MASK (SMOOTHING_PREMULTIPLIED | SMOOTHING_PREMULTIPLIED_OUTPUT)
+
+/*!
+\brief Internal helper which splits the smoothing flags of the public functions.
+
+\param smooth The smoothing flags passed by the caller.
+\param subpixel Pointer receiving the SMOOTHING_SUBPIXEL flag.
+
+\returns The smoothing flags for the transformers: 0 for no smoothing, otherwise nonzero
+including the premultiplied mode flags (which are dropped if smoothing is off).
+*/
+static int _smoothingFlags(int smooth, int *subpixel)
+{
+	*subpixel = (smooth & SMOOTHING_SUBPIXEL);
+	smooth &= ~SMOOTHING_SUBPIXEL;
+	if ((smooth & ~SMOOTHING_PREMULTIPLIED_MASK) == 0) {
+		return 0;
+	}
+	return smooth;
+}
+
+/*!
+\brief Internal helper for alpha weighted bilinear interpolation of 32 bit RGBA pixels.
+
+Interpolates the color channels premultiplied by alpha, so fully or partially
+transparent pixels do not bleed their (invisible) color into the result. The 
+result is either converted back to straight alpha or left premultiplied.
+Premultiplied results and fully opaque neighbourhoods, the common case, are
+computed without divisions.
+
+\param c00 The upper left source pixel.
+\param c01 The upper right source pixel.
+\param c10 The lower left source pixel.
+\param c11 The lower right source pixel.
+\param ex The horizontal 16 bit fraction.
+\param ey The vertical 16 bit fraction.
+\param premultipliedout Flag indicating the result should be left premultiplied.
+\param dp Pointer to the destination pixel.
+*/
+static void _interpolatePremultiplied(tColorRGBA c00, tColorRGBA c01, tColorRGBA c10, tColorRGBA c11, 
+	int ex, int ey, int premultipliedout, tColorRGBA *dp)
+{
+	Uint32 wx, wy, w00, w01, w10, w11, asum, r, g, b;
+
+	/* 8 bit weights summing up to 65536 */
+	wx = (Uint32)ex >> 8;
+	wy = (Uint32)ey >> 8;
+	w00 = (256 - wx) * (256 - wy) * c00.a;
+	w01 = wx * (256 - wy) * c01.a;
+	w10 = (256 - wx) * wy * c10.a;
+	w11 = wx * wy * c11.a;
+	asum = w00 + w01 + w10 + w11;
+	if (asum == 0) {
+		dp->r = dp->g = dp->b = dp->a = 0;
+		return;
+	}
+
+	r = w00 * c00.r + w01 * c01.r + w10 * c10.r + w11 * c11.r;
+	g = w00 * c00.g + w01 * c01.g + w10 * c10.g + w11 * c11.g;
+	b = w00 * c00.b + w01 * c01.b + w10 * c10.b + w11 * c11.b;
+	dp->a = (Uint8)((asum + 32768) >> 16);
+	if ((premultipliedout) || (asum == 255 * 65536)) {
+		/* Exact division by 255*65536 (also the alpha sum of 4 opaque pixels): x/255 == (x*32897)>>23 for x < 65536 */
+		dp->r = (Uint8)(((((r + 255 * 32768) >> 16) * 32897) >> 23));
+		dp->g = (Uint8)(((((g + 255 * 32768) >> 16) * 32897) >> 23));
+		dp->b = (Uint8)(((((b + 255 * 32768) >> 16) * 32897) >> 23));
+	} else {
+		/* Partially transparent neighbourhood: divide by the alpha sum */
+		dp->r = (Uint8)((r + asum / 2) / asum);
+		dp->g = (Uint8)((g + asum / 2) / asum);
+		dp->b = (Uint8)((b + asum / 2) / asum);
+	}
+}
+
+/*!
+\brief Internal helper which shrinks one row of 32 bit pixels by 2x2 averaging.
+
+Matches the truncating average of the generic shrinker. Processes 4 destination
+pixels at a time with SSE2 (16 bit sums of 8 source pixels per row).
+
+\param s0 Pointer to the upper source row.
+\param s1 Pointer to the lower source row.
+\param d Pointer to the destination row.
+\param dw The number of destination pixels.
+*/
+static void _shrinkRowRGBA2x2(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int dw)
+{
+	int x, c;
+#ifdef USE_SSE2_ROTOZOOM
+	__m128i zero, lo, hi, sa, sb, r0, r1;
+
+	zero = _mm_setzero_si128();
+	for (x = 0; x + 4 <= dw; x += 4) {
+		/* Source pixels 0-3: row sums, then sum of horizontal neighbors */
+		r0 = _mm_loadu_si128((const __m128i *)s0);
+		r1 = _mm_loadu_si128((const __m128i *)s1);
+		lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+		hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+		sa = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+		/* Source pixels 4-7 */
+		r0 = _mm_loadu_si128((const __m128i *)(s0 + 16));
+		r1 = _mm_loadu_si128((const __m128i *)(s1 + 16));
+		lo = _mm_add_epi16(_mm_unpacklo_epi8(r0, zero), _mm_unpacklo_epi8(r1, zero));
+		hi = _mm_add_epi16(_mm_unpackhi_epi8(r0, zero), _mm_unpackhi_epi8(r1, zero));
+		sb = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+		_mm_storeu_si128((__m128i *)d, _mm_packus_epi16(_mm_srli_epi16(sa, 2), _mm_srli_epi16(sb, 2)));
+		s0 += 32;
+		s1 += 32;
+		d += 16;
+	}
+#else
+	x = 0;
+#endif
+	for (; x < dw; x++) {
+		for (c = 0; c < 4; c++) {
+			d[c] = (Uint8)((s0[c] + s0[c + 4] + s1[c] + s1[c + 4]) >> 2);
+		}
+		s0 += 8;
+		s1 += 8;
+		d += 4;
+	}
+}
+
+#ifdef USE_SSE2_ROTOZOOM
+/*!
+\brief Internal helper which shrinks one row of 32 bit pixels by 4x4 averaging.
+
+Matches the truncating average of the generic shrinker. Processes 4 destination
+pixels at a time with SSE2 (16 bit sums of each 4x4 source box); only available 
+with SSE2 since the generic shrinker is as fast otherwise.
+
+\param s Pointer to the first of the 4 source rows.
+\param spitch The pitch of the source surface.
+\param d Pointer to the destination row.
+\param dw The number of destination pixels.
+*/
+static void _shrinkRowRGBA4x4(const Uint8 *s, int spitch, Uint8 *d, int dw)
+{
+	int x, c, dx, dy, sum[4];
+	__m128i zero, lo, hi, r, box[4];
+	int i;
+
+	zero = _mm_setzero_si128();
+	for (x = 0; x + 4 <= dw; x += 4) {
+		for (i = 0; i < 4; i++) {
+			/* Column sums of the 4 rows, then sum of the 4 columns in the low quadword */
+			lo = hi = zero;
+			for (dy = 0; dy < 4; dy++) {
+				r = _mm_loadu_si128((const __m128i *)(s + dy * spitch + i * 16));
+				lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(r, zero));
+				hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(r, zero));
+			}
+			lo = _mm_add_epi16(lo, hi);
+			box[i] = _mm_add_epi16(lo, _mm_unpackhi_epi64(lo, lo));
+		}
+		lo = _mm_srli_epi16(_mm_unpacklo_epi64(box[0], box[1]), 4);
+		hi = _mm_srli_epi16(_mm_unpacklo_epi64(box[2], box[3]), 4);
+		_mm_storeu_si128((__m128i *)d, _mm_packus_epi16(lo, hi));
+		s += 64;
+		d += 16;
+	}
+	for (; x < dw; x++) {
+		sum[0] = sum[1] = sum[2] = sum[3] = 0;
+		for (dy = 0; dy < 4; dy++) {
+			for (dx = 0; dx < 16; dx += 4) {
+				for (c = 0; c < 4; c++) {
+					sum[c] += s[dy * spitch + dx + c];
+				}
+			}
+		}
+		for (c = 0; c < 4; c++) {
+			d[c] = (Uint8)(sum[c] >> 4);
+		}
+		s += 16;
+		d += 4;
+	}
+}
+#endif
+
 /*! 
 \brief Internal 32 bit integer-factor averaging Shrinker.
 
@@ -110,6 +317,27 @@ int _shrinkSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int factorx, int fa
 	tColorRGBA *sp, *osp, *oosp;
 	tColorRGBA *dp;
 
+	/*
+	* Fast paths for the common 1/2 and 1/4 size shrinks
+	*/
+	if ((factorx == 2) && (factory == 2)) {
+		for (y = 0; y < dst->h; y++) {
+			_shrinkRowRGBA2x2((Uint8 *)src->pixels + (2 * y) * src->pitch, 
+				(Uint8 *)src->pixels + (2 * y + 1) * src->pitch, 
+				(Uint8 *)dst->pixels + y * dst->pitch, dst->w);
+		}
+		return (0);
+	}
+#ifdef USE_SSE2_ROTOZOOM
+	if ((factorx == 4) && (factory == 4)) {
+		for (y = 0; y < dst->h; y++) {
+			_shrinkRowRGBA4x4((Uint8 *)src->pixels + (4 * y) * src->pitch, src->pitch, 
+				(Uint8 *)dst->pixels + y * dst->pitch, dst->w);
+		}
+		return (0);
+	}
+#endif
+
 	/*
 	* Averaging integer shrink
 	*/
@@ -259,6 +487,37 @@ int _shrinkSurfaceY(SDL_Surface * src, SDL_Surface * dst, int factorx, int facto
 	return (0);
 }
 
+/*!
+\brief Internal helper which calculates the 16.16 source positions of a zoom.
+
+With smoothing the first and last pixels of source and destination are aligned, 
+otherwise the pixel grids are scaled. Positions are clamped to the source size.
+
+\param ssize The source width or height.
+\param dsize The destination width or height.
+\param smooth Flag indicating interpolation is used.
+\param table Array of dsize+1 entries receiving the positions.
+*/
+static void _zoomSampleTable(int ssize, int dsize, int smooth, int *table)
+{
+	int i, step, pos, maxpos;
+
+	if (smooth) {
+		step = (int) (65536.0 * (float) (ssize - 1) / (float) (dsize - 1));
+	} else {
+		step = (int) (65536.0 * (float) (ssize) / (float) (dsize));
+	}
+	maxpos = (ssize << 16) - 1;
+	pos = 0;
+	for (i = 0; i <= dsize; i++) {
+		table[i] = pos;
+		pos += step;
+		if (pos > maxpos) {
+			pos = maxpos;
+		}
+	}
+}
+
 /*! 
 \brief Internal 32 bit Zoomer with optional anti-aliasing by bilinear interpolation.
 
@@ -270,24 +529,27 @@ Assumes dst surface was allocated with the correct dimensions.
 \param dst The zoomed surface (output).
 \param flipx Flag indicating if the image should be horizontally flipped.
 \param flipy Flag indicating if the image should be vertically flipped.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. SMOOTHING_PREMULTIPLIED and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
 
 \return 0 for success or -1 for error.
 */
 int _zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth)
 {
-	int x, y, sx, sy, ssx, ssy, *sax, *say, *csax, *csay, *salast, csx, csy, ex, ey, cx, cy, sstep, sstepx, sstepy;
+	int x, y, *sax, *say, *csax, *csay, *salast, ex, ey, cx, cy, sstep, sstepx, sstepy;
 	tColorRGBA *c00, *c01, *c10, *c11;
 	tColorRGBA *sp, *csp, *dp;
-	int spixelgap, spixelw, spixelh, dgap, t1, t2;
+	int spixelgap, spixelw, spixelh, dgap, t1, t2, premultiplied, premultipliedout;
+
+	premultiplied = (smooth & SMOOTHING_PREMULTIPLIED_MASK);
+	premultipliedout = (smooth & SMOOTHING_PREMULTIPLIED_OUTPUT);
 
 	/*
 	* Allocate memory for row/column increments 
 	*/
-	if ((sax = (int *) malloc((dst->w + 1) * sizeof(Uint32))) == NULL) {
+	if ((sax = (int *) malloc((dst->w + 1) * sizeof(int))) == NULL) {
 		return (-1);
 	}
-	if ((say = (int *) malloc((dst->h + 1) * sizeof(Uint32))) == NULL) {
+	if ((say = (int *) malloc((dst->h + 1) * sizeof(int))) == NULL) {
 		free(sax);
 		return (-1);
 	}
@@ -297,45 +559,8 @@ int _zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 	*/
 	spixelw = (src->w - 1);
 	spixelh = (src->h - 1);
-	if (smooth) {
-		sx = (int) (65536.0 * (float) spixelw / (float) (dst->w - 1));
-		sy = (int) (65536.0 * (float) spixelh / (float) (dst->h - 1));
-	} else {
-		sx = (int) (65536.0 * (float) (src->w) / (float) (dst->w));
-		sy = (int) (65536.0 * (float) (src->h) / (float) (dst->h));
-	}
-
-	/* Maximum scaled source size */
-	ssx = (src->w << 16) - 1;
-	ssy = (src->h << 16) - 1;
-
-	/* Precalculate horizontal row increments */
-	csx = 0;
-	csax = sax;
-	for (x = 0; x <= dst->w; x++) {
-		*csax = csx;
-		csax++;
-		csx += sx;
-
-		/* Guard from overflows */
-		if (csx > ssx) { 
-			csx = ssx; 
-		}
-	}
-
-	/* Precalculate vertical row increments */
-	csy = 0;
-	csay = say;
-	for (y = 0; y <= dst->h; y++) {
-		*csay = csy;
-		csay++;
-		csy += sy;
-
-		/* Guard from overflows */
-		if (csy > ssy) {
-			csy = ssy;
-		}
-	}
+	_zoomSampleTable(src->w, dst->w, smooth, sax);
+	_zoomSampleTable(src->h, dst->h, smooth, say);
 
 	sp = (tColorRGBA *) src->pixels;
 	dp = (tColorRGBA *) dst->pixels;
@@ -391,18 +616,22 @@ int _zoomSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy,
 				/*
 				* Draw and interpolate colors 
 				*/
-				t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-				t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-				dp->r = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-				t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-				dp->g = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-				t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-				dp->b = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-				t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-				dp->a = (((t2 - t1) * ey) >> 16) + t1;				
+				if (premultiplied) {
+					_interpolatePremultiplied(*c00, *c01, *c10, *c11, ex, ey, premultipliedout, dp);
+				} else {
+					t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
+					t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
+					dp->r = (((t2 - t1) * ey) >> 16) + t1;
+					t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
+					t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
+					dp->g = (((t2 - t1) * ey) >> 16) + t1;
+					t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
+					t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
+					dp->b = (((t2 - t1) * ey) >> 16) + t1;
+					t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
+					t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
+					dp->a = (((t2 - t1) * ey) >> 16) + t1;
+				}
 				/*
 				* Advance source pointer x
 				*/
@@ -607,12 +836,93 @@ int _zoomSurfaceY(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
 	return (0);
 }
 
+/*!
+\brief Internal helper to check if a fixed point source coordinate is within a range.
+
+\param s The 16.16 fixed point source coordinate of the first pixel in the row.
+\param ds The 16.16 fixed point source coordinate increment per destination pixel.
+\param x The destination pixel position in the row.
+\param lo The lowest valid integer source coordinate.
+\param hi The highest valid integer source coordinate.
+
+\return 1 if the source coordinate of pixel x is within [lo,hi], 0 otherwise.
+*/
+static int _transformInSpan(int s, int ds, int x, int lo, int hi)
+{
+	int c;
+
+	c = (s + ds * x) >> 16;
+	return ((c >= lo) && (c <= hi));
+}
+
+/*!
+\brief Internal helper to clip a destination row to the pixels with valid source coordinates.
+
+Narrows the destination span [*xstart, *xend) to the pixels for which the 
+integer part of the 16.16 fixed point source coordinate s + ds * x is within
+[lo,hi]. Since the source coordinate is linear in x, the valid pixels of a
+row are always contiguous. The span is estimated in floating point and then
+adjusted using the same integer arithmetic the scanner uses.
+
+\param s The 16.16 fixed point source coordinate of the first pixel in the row.
+\param ds The 16.16 fixed point source coordinate increment per destination pixel.
+\param lo The lowest valid integer source coordinate.
+\param hi The highest valid integer source coordinate.
+\param xstart Pointer to the first pixel of the span (input and output).
+\param xend Pointer to the end of the span (exclusive, input and output).
+*/
+static void _transformClipSpan(int s, int ds, int lo, int hi, int *xstart, int *xend)
+{
+	int x0, x1;
+	double fa, fb, ft;
+
+	if (*xstart >= *xend) {
+		return;
+	}
+
+	/* Constant coordinate: either the whole span is valid or nothing is */
+	if (ds == 0) {
+		if (!_transformInSpan(s, ds, 0, lo, hi)) {
+			*xend = *xstart;
+		}
+		return;
+	}
+
+	/* Estimate the span from lo <= (s + ds * x) / 65536 < hi + 1 */
+	fa = ((double)lo * 65536.0 - (double)s) / (double)ds;
+	fb = ((double)(hi + 1) * 65536.0 - (double)s) / (double)ds;
+	if (ds < 0) {
+		ft = fa; fa = fb; fb = ft;
+	}
+	fa = ceil(fa);
+	fb = ceil(fb);
+	if (fa < (double)*xstart) fa = (double)*xstart;
+	if (fa > (double)*xend) fa = (double)*xend;
+	if (fb < fa) fb = fa;
+	if (fb > (double)*xend) fb = (double)*xend;
+	x0 = (int)fa;
+	x1 = (int)fb;
+
+	/* Adjust estimates to the exact integer result */
+	while ((x0 < x1) && !_transformInSpan(s, ds, x0, lo, hi)) x0++;
+	while ((x0 > *xstart) && _transformInSpan(s, ds, x0 - 1, lo, hi)) x0--;
+	while ((x1 > x0) && !_transformInSpan(s, ds, x1 - 1, lo, hi)) x1--;
+	while ((x1 < *xend) && _transformInSpan(s, ds, x1, lo, hi)) x1++;
+
+	*xstart = x0;
+	*xend = x1;
+}
+
 /*! 
 \brief Internal 32 bit rotozoomer with optional anti-aliasing.
 
 Rotates and zooms 32 bit RGBA/ABGR 'src' surface to 'dst' surface based on the control 
 parameters by scanning the destination surface and applying optionally anti-aliasing
 by bilinear interpolation.
+The destination is scanned in tiles of TRANSFORM_TILE_SIZE x TRANSFORM_TILE_SIZE
+pixels to keep source reads cache friendly for any angle. For each row the range 
+of pixels with a valid source position is calculated upfront, so the inner loops 
+run without bounds checks.
 Assumes src and dst surfaces are of 32 bit depth.
 Assumes dst surface was allocated with the correct dimensions.
 
@@ -624,14 +934,17 @@ Assumes dst surface was allocated with the correct dimensions.
 \param icos Integer version of cosine of angle.
 \param flipx Flag indicating horizontal mirroring should be applied.
 \param flipy Flag indicating vertical mirroring should be applied.
-\param smooth Flag indicating anti-aliasing should be used.
+\param smooth Flag indicating anti-aliasing should be used. SMOOTHING_PREMULTIPLIED and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
 */
 void _transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
 {
 	int x, y, t1, t2, dx, dy, xd, yd, sdx, sdy, ax, ay, ex, ey, sw, sh;
+	int tx, ty, txend, tyend, xs, xe, lox, hix, loy, hiy, spixelgap;
+	int premultiplied, premultipliedout;
+	int rowsdx[TRANSFORM_TILE_SIZE], rowsdy[TRANSFORM_TILE_SIZE];
+	int rowxs[TRANSFORM_TILE_SIZE], rowxe[TRANSFORM_TILE_SIZE];
 	tColorRGBA c00, c01, c10, c11, cswap;
 	tColorRGBA *pc, *sp;
-	int gap;
 
 	/*
 	* Variable setup 
@@ -642,85 +955,126 @@ void _transformSurfaceRGBA(SDL_Surface * src, SDL_Surface * dst, int cx, int cy,
 	ay = (cy << 16) - (isin * cx);
 	sw = src->w - 1;
 	sh = src->h - 1;
-	pc = (tColorRGBA*) dst->pixels;
-	gap = dst->pitch - dst->w * 4;
+	spixelgap = src->pitch/4;
+	premultiplied = (smooth & SMOOTHING_PREMULTIPLIED_MASK);
+	premultipliedout = (smooth & SMOOTHING_PREMULTIPLIED_OUTPUT);
 
 	/*
-	* Switch between interpolating and non-interpolating code 
+	* Valid range of unflipped source coordinates; interpolation needs
+	* the right and lower neighbor pixel as well
 	*/
 	if (smooth) {
-		for (y = 0; y < dst->h; y++) {
+		lox = (flipx) ? 1 : 0;
+		hix = (flipx) ? sw : sw - 1;
+		loy = (flipy) ? 1 : 0;
+		hiy = (flipy) ? sh : sh - 1;
+	} else {
+		lox = 0;
+		hix = sw;
+		loy = 0;
+		hiy = sh;
+	}
+
+	/*
+	* Scan destination in tiles 
+	*/
+	for (ty = 0; ty < dst->h; ty += TRANSFORM_TILE_SIZE) {
+		tyend = MIN(ty + TRANSFORM_TILE_SIZE, dst->h);
+
+		/*
+		* Setup source coordinates and valid span of the rows in this band
+		*/
+		for (y = ty; y < tyend; y++) {
 			dy = cy - y;
 			sdx = (ax + (isin * dy)) + xd;
 			sdy = (ay - (icos * dy)) + yd;
-			for (x = 0; x < dst->w; x++) {
-				dx = (sdx >> 16);
-				dy = (sdy >> 16);
-				if (flipx) dx = sw - dx;
-				if (flipy) dy = sh - dy;
-				if ((dx > -1) && (dy > -1) && (dx < (src->w-1)) && (dy < (src->h-1))) {
-					sp = (tColorRGBA *)src->pixels;;
-					sp += ((src->pitch/4) * dy);
-					sp += dx;
-					c00 = *sp;
-					sp += 1;
-					c01 = *sp;
-					sp += (src->pitch/4);
-					c11 = *sp;
-					sp -= 1;
-					c10 = *sp;
-					if (flipx) {
-						cswap = c00; c00=c01; c01=cswap;
-						cswap = c10; c10=c11; c11=cswap;
+			xs = 0;
+			xe = dst->w;
+			_transformClipSpan(sdx, icos, lox, hix, &xs, &xe);
+			_transformClipSpan(sdy, isin, loy, hiy, &xs, &xe);
+			rowsdx[y - ty] = sdx;
+			rowsdy[y - ty] = sdy;
+			rowxs[y - ty] = xs;
+			rowxe[y - ty] = xe;
+		}
+
+		for (tx = 0; tx < dst->w; tx += TRANSFORM_TILE_SIZE) {
+			txend = MIN(tx + TRANSFORM_TILE_SIZE, dst->w);
+			for (y = ty; y < tyend; y++) {
+				xs = MAX(rowxs[y - ty], tx);
+				xe = MIN(rowxe[y - ty], txend);
+				if (xs >= xe) {
+					continue;
+				}
+				sdx = rowsdx[y - ty] + (icos * xs);
+				sdy = rowsdy[y - ty] + (isin * xs);
+				pc = (tColorRGBA *) ((Uint8 *) dst->pixels + dst->pitch * y);
+				pc += xs;
+
+				/*
+				* Switch between interpolating and non-interpolating code 
+				*/
+				if (smooth) {
+					for (x = xs; x < xe; x++) {
+						dx = (sdx >> 16);
+						dy = (sdy >> 16);
+						if (flipx) dx = sw - dx;
+						if (flipy) dy = sh - dy;
+						sp = (tColorRGBA *)src->pixels;
+						sp += (spixelgap * dy);
+						sp += dx;
+						c00 = *sp;
+						c01 = *(sp + 1);
+						c10 = *(sp + spixelgap);
+						c11 = *(sp + spixelgap + 1);
+						if (flipx) {
+							cswap = c00; c00=c01; c01=cswap;
+							cswap = c10; c10=c11; c11=cswap;
+						}
+						if (flipy) {
+							cswap = c00; c00=c10; c10=cswap;
+							cswap = c01; c01=c11; c11=cswap;
+						}
+						/*
+						* Interpolate colors 
+						*/
+						ex = (sdx & 0xffff);
+						ey = (sdy & 0xffff);
+						if (premultiplied) {
+							_interpolatePremultiplied(c00, c01, c10, c11, ex, ey, premultipliedout, pc);
+						} else {
+							t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
+							t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
+							pc->r = (((t2 - t1) * ey) >> 16) + t1;
+							t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
+							t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
+							pc->g = (((t2 - t1) * ey) >> 16) + t1;
+							t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
+							t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
+							pc->b = (((t2 - t1) * ey) >> 16) + t1;
+							t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
+							t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
+							pc->a = (((t2 - t1) * ey) >> 16) + t1;
+						}
+						sdx += icos;
+						sdy += isin;
+						pc++;
 					}
-					if (flipy) {
-						cswap = c00; c00=c10; c10=cswap;
-						cswap = c01; c01=c11; c11=cswap;
+				} else {
+					for (x = xs; x < xe; x++) {
+						dx = (sdx >> 16);
+						dy = (sdy >> 16);
+						if (flipx) dx = sw - dx;
+						if (flipy) dy = sh - dy;
+						sp = (tColorRGBA *) ((Uint8 *) src->pixels + src->pitch * dy);
+						sp += dx;
+						*pc = *sp;
+						sdx += icos;
+						sdy += isin;
+						pc++;
 					}
-					/*
-					* Interpolate colors 
-					*/
-					ex = (sdx & 0xffff);
-					ey = (sdy & 0xffff);
-					t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-					t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-					pc->r = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-					t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-					pc->g = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-					t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-					pc->b = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-					t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-					pc->a = (((t2 - t1) * ey) >> 16) + t1;
-				}
-				sdx += icos;
-				sdy += isin;
-				pc++;
-			}
-			pc = (tColorRGBA *) ((Uint8 *) pc + gap);
-		}
-	} else {
-		for (y = 0; y < dst->h; y++) {
-			dy = cy - y;
-			sdx = (ax + (isin * dy)) + xd;
-			sdy = (ay - (icos * dy)) + yd;
-			for (x = 0; x < dst->w; x++) {
-				dx = (short) (sdx >> 16);
-				dy = (short) (sdy >> 16);
-				if (flipx) dx = (src->w-1)-dx;
-				if (flipy) dy = (src->h-1)-dy;
-				if ((dx >= 0) && (dy >= 0) && (dx < src->w) && (dy < src->h)) {
-					sp = (tColorRGBA *) ((Uint8 *) src->pixels + src->pitch * dy);
-					sp += dx;
-					*pc = *sp;
 				}
-				sdx += icos;
-				sdy += isin;
-				pc++;
 			}
-			pc = (tColorRGBA *) ((Uint8 *) pc + gap);
 		}
 	}
 }
@@ -788,111 +1142,1522 @@ void transformSurfaceY(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int
 }
 
 /*!
-\brief Rotates a 8/16/24/32 bit surface in increments of 90 degrees.
-
-Specialized 90 degree rotator which rotates a 'src' surface in 90 degree 
-increments clockwise returning a new surface. Faster than rotozoomer since
-no scanning or interpolation takes place. Input surface must be 8/16/24/32 bit.
-(code contributed by J. Schiller, improved by C. Allport and A. Schiffler)
+\brief Internal helper which checks for an 8 bit grayscale (identity) palette.
 
-\param src Source surface to rotate.
-\param numClockwiseTurns Number of clockwise 90 degree turns to apply to the source.
+\param src The surface to check.
 
-\returns The new, rotated surface; or NULL for surfaces with incorrect input format.
+\returns 1 if the surface is 8 bit and palette entry i is the gray level i for all 256 entries, 0 otherwise.
 */
-SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns) 
+static int _isGrayscalePalette(SDL_Surface *src)
 {
-	int row, col, newWidth, newHeight;
-	int bpp, bpr;
-	SDL_Surface* dst;
-	Uint8* srcBuf;
-	Uint8* dstBuf;
-	int normalizedClockwiseTurns;
+	int i;
+	SDL_Palette *palette;
 
-	/* Has to be a valid surface pointer and be a Nbit surface where n is divisible by 8 */
-	if (!src || 
-	    !src->format) {
-		SDL_SetError("NULL source surface or source surface format");
-	    return NULL; 
+	if ((src->format->BitsPerPixel != 8) || (src->format->palette == NULL)) {
+		return 0;
 	}
-
-	if ((src->format->BitsPerPixel % 8) != 0) {
-		SDL_SetError("Invalid source surface bit depth");
-	    return NULL; 
+	palette = src->format->palette;
+	if (palette->ncolors != 256) {
+		return 0;
 	}
-
-	/* normalize numClockwiseTurns */
-	normalizedClockwiseTurns = (numClockwiseTurns % 4);
-	if (normalizedClockwiseTurns < 0) {
-		normalizedClockwiseTurns += 4;
+	for (i = 0; i < 256; i++) {
+		if ((palette->colors[i].r != i) || (palette->colors[i].g != i) || (palette->colors[i].b != i)) {
+			return 0;
+		}
 	}
+	return 1;
+}
 
-	/* If turns are even, our new width/height will be the same as the source surface */
-	if (normalizedClockwiseTurns % 2) {
-		newWidth = src->h;
-		newHeight = src->w;
-	} else {
-		newWidth = src->w;
-		newHeight = src->h;
-	}
+/*!
+\brief Internal helper which interpolates one 8 bit source row horizontally.
 
-	dst = SDL_CreateRGBSurface( src->flags, newWidth, newHeight, src->format->BitsPerPixel,
-		src->format->Rmask,
-		src->format->Gmask, 
-		src->format->Bmask, 
-		src->format->Amask);
-	if(!dst) {
-		SDL_SetError("Could not create destination surface"); 
-		return NULL;
-	}
+Gathers the source pixel pairs of 8 destination pixels at a time and interpolates
+them with SSE2 (like _blendRowsY() with a per pixel fraction).
 
-	if (SDL_MUSTLOCK(src)) {
-		SDL_LockSurface(src);
+\param srow Pointer to the source row.
+\param drow Pointer to the row receiving dw interpolated values.
+\param sax The 16.16 horizontal source positions.
+\param dw The width of the destination.
+\param spixelw The index of the last source pixel.
+\param flipx Flag indicating the row should be horizontally flipped.
+*/
+static void _zoomRowY(const Uint8 *srow, Uint8 *drow, const int *sax, int dw, int spixelw, int flipx)
+{
+	int x, cx, cx1, ex, a, b;
+#ifdef USE_SSE2_ROTOZOOM
+	int i, i0[8], i1[8];
+	__m128i av, dv, ev;
+
+	for (x = 0; x + 8 <= dw; x += 8) {
+		/* Gather the 8 pixel pairs, then interpolate them as 16 bit values */
+		for (i = 0; i < 8; i++) {
+			cx = sax[x + i] >> 16;
+			cx1 = (cx < spixelw) ? cx + 1 : cx;
+			if (flipx) {
+				cx = spixelw - cx;
+				cx1 = spixelw - cx1;
+			}
+			i0[i] = cx;
+			i1[i] = cx1;
+		}
+		av = _mm_setr_epi16(srow[i0[0]], srow[i0[1]], srow[i0[2]], srow[i0[3]], srow[i0[4]], srow[i0[5]], srow[i0[6]], srow[i0[7]]);
+		dv = _mm_sub_epi16(_mm_setr_epi16(srow[i1[0]], srow[i1[1]], srow[i1[2]], srow[i1[3]], srow[i1[4]], srow[i1[5]], srow[i1[6]], srow[i1[7]]), av);
+		ev = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(sax + x)), 16), 16),
+			_mm_srai_epi32(_mm_slli_epi32(_mm_loadu_si128((const __m128i *)(sax + x + 4)), 16), 16));
+		av = _mm_add_epi16(av, _mm_mulhi_epi16(dv, ev));
+		av = _mm_add_epi16(av, _mm_and_si128(dv, _mm_srai_epi16(ev, 15)));
+		_mm_storel_epi64((__m128i *)(drow + x), _mm_packus_epi16(av, av));
 	}
-	if (SDL_MUSTLOCK(dst)) {
-		SDL_LockSurface(dst);
+#else
+	x = 0;
+#endif
+	for (; x < dw; x++) {
+		cx = sax[x] >> 16;
+		ex = sax[x] & 0xffff;
+		cx1 = (cx < spixelw) ? cx + 1 : cx;
+		if (flipx) {
+			cx = spixelw - cx;
+			cx1 = spixelw - cx1;
+		}
+		a = srow[cx];
+		b = srow[cx1];
+		drow[x] = (Uint8)((((b - a) * ex) >> 16) + a);
 	}
+}
 
-	/* Calculate byte-per-pixel */
-	bpp = src->format->BitsPerPixel / 8;
+/*!
+\brief Internal helper which interpolates between two 8 bit rows.
 
-	switch(normalizedClockwiseTurns) {
-	case 0: /* Make a copy of the surface */
-		{
-			/* Unfortunately SDL_BlitSurface cannot be used to make a copy of the surface
-			since it does not preserve alpha. */
+Calculates d = r0 + ((r1 - r0) * ey) >> 16 for each value, 16 values at a time with SSE2.
 
-			if (src->pitch == dst->pitch) {
-				/* If the pitch is the same for both surfaces, the memory can be copied all at once. */
-				memcpy(dst->pixels, src->pixels, (src->h * src->pitch));
-			}
-			else
-			{
-				/* If the pitch differs, copy each row separately */
-				srcBuf = (Uint8*)(src->pixels);
-				dstBuf = (Uint8*)(dst->pixels);
-				bpr = src->w * bpp;
-				for (row = 0; row < src->h; row++) {
-					memcpy(dstBuf, srcBuf, bpr);
-					srcBuf += src->pitch;
-					dstBuf += dst->pitch;
-				}
-			}
-		}
-		break;
+\param r0 Pointer to the upper row.
+\param r1 Pointer to the lower row.
+\param d Pointer to the destination row.
+\param w The number of values.
+\param ey The vertical 16 bit fraction.
+*/
+static void _blendRowsY(const Uint8 *r0, const Uint8 *r1, Uint8 *d, int w, int ey)
+{
+	int x;
+#ifdef USE_SSE2_ROTOZOOM
+	__m128i zero, eyv, a, b, lo, hi, dlo, dhi;
 
-		/* rotate clockwise */
-	case 1: /* rotated 90 degrees clockwise */
+	/* 
+	* The signed multiply sees ey - 65536 for ey >= 32768; adding the
+	* difference once more corrects the high word of the product
+	*/
+	zero = _mm_setzero_si128();
+	eyv = _mm_set1_epi16((short)ey);
+	for (x = 0; x + 16 <= w; x += 16) {
+		a = _mm_loadu_si128((const __m128i *)(r0 + x));
+		b = _mm_loadu_si128((const __m128i *)(r1 + x));
+		lo = _mm_unpacklo_epi8(a, zero);
+		hi = _mm_unpackhi_epi8(a, zero);
+		dlo = _mm_sub_epi16(_mm_unpacklo_epi8(b, zero), lo);
+		dhi = _mm_sub_epi16(_mm_unpackhi_epi8(b, zero), hi);
+		if (ey & 0x8000) {
+			lo = _mm_add_epi16(lo, dlo);
+			hi = _mm_add_epi16(hi, dhi);
+		}
+		lo = _mm_add_epi16(lo, _mm_mulhi_epi16(dlo, eyv));
+		hi = _mm_add_epi16(hi, _mm_mulhi_epi16(dhi, eyv));
+		_mm_storeu_si128((__m128i *)(d + x), _mm_packus_epi16(lo, hi));
+	}
+#else
+	x = 0;
+#endif
+	for (; x < w; x++) {
+		d[x] = (Uint8)((((r1[x] - r0[x]) * ey) >> 16) + r0[x]);
+	}
+}
+
+/*! 
+\brief Internal 8 bit grayscale Zoomer with anti-aliasing by bilinear interpolation.
+
+Zooms 8 bit 'src' surface with a grayscale (identity) palette to 'dst' surface by
+interpolating the pixel values directly. Samples the same source positions and
+produces the same values as _zoomSurfaceRGBA() does for the equivalent gray 32 bit
+surface. Source rows are interpolated horizontally once and reused while consecutive
+destination rows need them; the vertical interpolation uses SSE2.
+Assumes src and dst surfaces are of 8 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomSurfaceYSmooth(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy)
+{
+	int y, k, b, cy, cy1, ey, need[2], rowidx[2], slot[2], spixelw, spixelh;
+	int *sax, *say;
+	Uint8 *rows[2];
+
+	/*
+	* Allocate memory for positions and the two horizontally interpolated rows
+	*/
+	sax = (int *) malloc((dst->w + 1) * sizeof(int));
+	say = (int *) malloc((dst->h + 1) * sizeof(int));
+	rows[0] = (Uint8 *) malloc(dst->w * 2);
+	if ((sax == NULL) || (say == NULL) || (rows[0] == NULL)) {
+		free(sax);
+		free(say);
+		free(rows[0]);
+		return (-1);
+	}
+	rows[1] = rows[0] + dst->w;
+	rowidx[0] = rowidx[1] = -1;
+
+	spixelw = (src->w - 1);
+	spixelh = (src->h - 1);
+	_zoomSampleTable(src->w, dst->w, 1, sax);
+	_zoomSampleTable(src->h, dst->h, 1, say);
+
+	for (y = 0; y < dst->h; y++) {
+		cy = say[y] >> 16;
+		ey = say[y] & 0xffff;
+		cy1 = (cy < spixelh) ? cy + 1 : cy;
+		if (flipy) {
+			cy = spixelh - cy;
+			cy1 = spixelh - cy1;
+		}
+
+		/*
+		* Find or interpolate the two source rows
+		*/
+		need[0] = cy;
+		need[1] = cy1;
+		for (k = 0; k < 2; k++) {
+			if (rowidx[0] == need[k]) {
+				b = 0;
+			} else if (rowidx[1] == need[k]) {
+				b = 1;
+			} else {
+				b = (rowidx[0] == need[1 - k]) ? 1 : 0;
+				_zoomRowY((Uint8 *)src->pixels + need[k] * src->pitch, rows[b], sax, dst->w, spixelw, flipx);
+				rowidx[b] = need[k];
+			}
+			slot[k] = b;
+		}
+
+		_blendRowsY(rows[slot[0]], rows[slot[1]], (Uint8 *)dst->pixels + y * dst->pitch, dst->w, ey);
+	}
+
+	/*
+	* Remove temp arrays 
+	*/
+	free(sax);
+	free(say);
+	free(rows[0]);
+
+	return (0);
+}
+
+/*! 
+\brief Internal 8 bit grayscale rotozoomer with anti-aliasing by bilinear interpolation.
+
+Rotates and zooms 8 bit 'src' surface with a grayscale (identity) palette to 'dst' surface
+by interpolating the pixel values directly, with the same source positions as 
+_transformSurfaceRGBA(). Areas not covered by the source are set to the colorkey of the source.
+Assumes src and dst surfaces are of 8 bit depth.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src Source surface.
+\param dst Destination surface.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+*/
+static void _transformSurfaceYSmooth(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy)
+{
+	int x, y, dx, dy, xd, yd, sdx, sdy, ax, ay, ex, ey, sw, sh, xs, xe, t1, t2;
+	int c00, c01, c10, c11, cswap;
+	Uint8 *sp, *pc;
+
+	/*
+	* Variable setup 
+	*/
+	xd = ((src->w - dst->w) << 15);
+	yd = ((src->h - dst->h) << 15);
+	ax = (cx << 16) - (icos * cx);
+	ay = (cy << 16) - (isin * cx);
+	sw = src->w - 1;
+	sh = src->h - 1;
+
+	/*
+	* Clear surface to colorkey 
+	*/ 	
+	memset(dst->pixels, (int)(_colorkey(src) & 0xff), dst->pitch * dst->h);
+
+	/*
+	* Iterate through the valid span of each destination row
+	*/
+	for (y = 0; y < dst->h; y++) {
+		dy = cy - y;
+		sdx = (ax + (isin * dy)) + xd;
+		sdy = (ay - (icos * dy)) + yd;
+		xs = 0;
+		xe = dst->w;
+		_transformClipSpan(sdx, icos, (flipx) ? 1 : 0, (flipx) ? sw : sw - 1, &xs, &xe);
+		_transformClipSpan(sdy, isin, (flipy) ? 1 : 0, (flipy) ? sh : sh - 1, &xs, &xe);
+		sdx += icos * xs;
+		sdy += isin * xs;
+		pc = (Uint8 *)dst->pixels + y * dst->pitch + xs;
+		for (x = xs; x < xe; x++) {
+			dx = (sdx >> 16);
+			dy = (sdy >> 16);
+			if (flipx) dx = sw - dx;
+			if (flipy) dy = sh - dy;
+			sp = (Uint8 *)src->pixels + src->pitch * dy + dx;
+			c00 = sp[0];
+			c01 = sp[1];
+			c10 = sp[src->pitch];
+			c11 = sp[src->pitch + 1];
+			if (flipx) {
+				cswap = c00; c00=c01; c01=cswap;
+				cswap = c10; c10=c11; c11=cswap;
+			}
+			if (flipy) {
+				cswap = c00; c00=c10; c10=cswap;
+				cswap = c01; c01=c11; c11=cswap;
+			}
+			ex = (sdx & 0xffff);
+			ey = (sdy & 0xffff);
+			t1 = (((c01 - c00) * ex) >> 16) + c00;
+			t2 = (((c11 - c10) * ex) >> 16) + c10;
+			*pc = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+			sdx += icos;
+			sdy += isin;
+			pc++;
+		}
+	}
+}
+
+/*!
+\brief Packed 16 or 24 bit pixel layout with generic conversion by the format masks.
+*/
+#define PACKED_GENERIC	0
+
+/*!
+\brief Packed 16 bit pixel layout RGB565 (red in the high bits).
+*/
+#define PACKED_RGB565	1
+
+/*!
+\brief Packed 16 bit pixel layout RGB555 (red in the high bits).
+*/
+#define PACKED_RGB555	2
+
+/*!
+\brief Packed 24 bit pixel layout with one byte per color channel.
+*/
+#define PACKED_RGB24	3
+
+/*!
+\brief Number of pixels the 16 and 24 bit transformers convert at once.
+*/
+#define PACKED_CHUNK_SIZE 64
+
+/*!
+\brief Description of a packed 16 or 24 bit pixel format.
+*/
+typedef struct tPackedFormat {
+	SDL_PixelFormat *format;	/*!< The pixel format. */
+	int layout;		/*!< Pixel layout (PACKED_GENERIC, PACKED_RGB565, PACKED_RGB555 or PACKED_RGB24). */
+	int bpp;		/*!< Bytes per pixel (2 or 3). */
+	int offset[3];		/*!< Byte offsets of the red, green and blue channel (PACKED_RGB24 only). */
+} tPackedFormat;
+
+/*!
+\brief Internal helper which reads a packed 16 or 24 bit pixel value.
+
+\param p Pointer to the pixel.
+\param bpp Bytes per pixel (2 or 3).
+
+\returns The pixel value.
+*/
+static Uint32 _getPixelPacked(const Uint8 *p, int bpp)
+{
+	if (bpp == 2) {
+		return *(const Uint16 *)p;
+	}
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16);
+#else
+	return ((Uint32)p[0] << 16) | ((Uint32)p[1] << 8) | (Uint32)p[2];
+#endif
+}
+
+/*!
+\brief Internal helper which writes a packed 16 or 24 bit pixel value.
+
+\param p Pointer to the pixel.
+\param bpp Bytes per pixel (2 or 3).
+\param v The pixel value.
+*/
+static void _putPixelPacked(Uint8 *p, int bpp, Uint32 v)
+{
+	if (bpp == 2) {
+		*(Uint16 *)p = (Uint16)v;
+		return;
+	}
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	p[0] = (Uint8)v;
+	p[1] = (Uint8)(v >> 8);
+	p[2] = (Uint8)(v >> 16);
+#else
+	p[0] = (Uint8)(v >> 16);
+	p[1] = (Uint8)(v >> 8);
+	p[2] = (Uint8)v;
+#endif
+}
+
+/*!
+\brief Internal helper which returns the byte offset of a 24 bit channel.
+
+\param mask The channel mask.
+\param shift The channel shift.
+
+\returns The offset of the byte holding the channel or -1 if the channel is not a whole byte.
+*/
+static int _packedByteOffset(Uint32 mask, int shift)
+{
+	if (((shift & 7) != 0) || (shift > 16) || (mask != ((Uint32)0xff << shift))) {
+		return (-1);
+	}
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	return (shift / 8);
+#else
+	return (2 - shift / 8);
+#endif
+}
+
+/*!
+\brief Internal helper which selects the conversion loops for a packed 16 or 24 bit format.
+
+\param format The pixel format.
+\param pf Pointer to the format description to set up.
+*/
+static void _packedFormat(SDL_PixelFormat *format, tPackedFormat *pf)
+{
+	pf->format = format;
+	pf->bpp = format->BytesPerPixel;
+	pf->layout = PACKED_GENERIC;
+	if (format->Amask != 0) {
+		return;
+	}
+	if (pf->bpp == 2) {
+		if ((format->Rmask == 0xf800) && (format->Gmask == 0x07e0) && (format->Bmask == 0x001f)) {
+			pf->layout = PACKED_RGB565;
+		} else if ((format->Rmask == 0x7c00) && (format->Gmask == 0x03e0) && (format->Bmask == 0x001f)) {
+			pf->layout = PACKED_RGB555;
+		}
+	} else {
+		pf->offset[0] = _packedByteOffset(format->Rmask, format->Rshift);
+		pf->offset[1] = _packedByteOffset(format->Gmask, format->Gshift);
+		pf->offset[2] = _packedByteOffset(format->Bmask, format->Bshift);
+		if ((pf->offset[0] >= 0) && (pf->offset[1] >= 0) && (pf->offset[2] >= 0)) {
+			pf->layout = PACKED_RGB24;
+		}
+	}
+}
+
+/*!
+\brief Internal helper which expands a channel of a packed pixel value to 8 bits.
+
+The high bits are replicated into the low bits, so the full channel range 
+maps to 0..255 like SDL_GetRGBA() does.
+
+\param v The pixel value.
+\param mask The channel mask.
+\param shift The channel shift.
+\param loss The channel loss.
+
+\returns The 8 bit channel value (0 if the channel is not present).
+*/
+static Uint8 _expandChannel(Uint32 v, Uint32 mask, int shift, int loss)
+{
+	int bits;
+
+	if (mask == 0) {
+		return 0;
+	}
+	v = ((v & mask) >> shift) << loss;
+	for (bits = 8 - loss; bits < 8; bits <<= 1) {
+		v |= v >> bits;
+	}
+	return (Uint8)v;
+}
+
+/*!
+\brief Internal helper which converts packed 16 or 24 bit pixels to 32 bit RGBA.
+
+Reads the pixels at base + offset[i]. The format switch is done once per 
+call, so the per pixel loops are specialized for the common layouts. Formats 
+without alpha channel are returned opaque.
+
+\param pf The source format.
+\param base Base pointer of the source pixels.
+\param offset Array of byte offsets of the source pixels.
+\param n The number of pixels (at most PACKED_CHUNK_SIZE).
+\param c Array receiving the RGBA pixels.
+*/
+static void _unpackPixelsPacked(const tPackedFormat *pf, const Uint8 *base, const int *offset, int n, tColorRGBA *c)
+{
+	int i;
+	Uint32 v;
+	const Uint8 *p;
+	SDL_PixelFormat *f;
+
+	switch (pf->layout) {
+	case PACKED_RGB565:
+		for (i = 0; i < n; i++) {
+			v = *(const Uint16 *)(base + offset[i]);
+			c[i].r = (Uint8)(((v >> 8) & 0xf8) | (v >> 13));
+			c[i].g = (Uint8)(((v >> 3) & 0xfc) | ((v >> 9) & 0x03));
+			c[i].b = (Uint8)(((v << 3) & 0xf8) | ((v >> 2) & 0x07));
+			c[i].a = 255;
+		}
+		break;
+	case PACKED_RGB555:
+		for (i = 0; i < n; i++) {
+			v = *(const Uint16 *)(base + offset[i]);
+			c[i].r = (Uint8)(((v >> 7) & 0xf8) | ((v >> 12) & 0x07));
+			c[i].g = (Uint8)(((v >> 2) & 0xf8) | ((v >> 7) & 0x07));
+			c[i].b = (Uint8)(((v << 3) & 0xf8) | ((v >> 2) & 0x07));
+			c[i].a = 255;
+		}
+		break;
+	case PACKED_RGB24:
+		for (i = 0; i < n; i++) {
+			p = base + offset[i];
+			c[i].r = p[pf->offset[0]];
+			c[i].g = p[pf->offset[1]];
+			c[i].b = p[pf->offset[2]];
+			c[i].a = 255;
+		}
+		break;
+	default:
+		f = pf->format;
+		for (i = 0; i < n; i++) {
+			v = _getPixelPacked(base + offset[i], pf->bpp);
+			c[i].r = _expandChannel(v, f->Rmask, f->Rshift, f->Rloss);
+			c[i].g = _expandChannel(v, f->Gmask, f->Gshift, f->Gloss);
+			c[i].b = _expandChannel(v, f->Bmask, f->Bshift, f->Bloss);
+			c[i].a = (f->Amask) ? _expandChannel(v, f->Amask, f->Ashift, f->Aloss) : 255;
+		}
+		break;
+	}
+}
+
+/*!
+\brief Internal helper which converts 32 bit RGBA pixels to consecutive packed 16 or 24 bit pixels.
+
+The channels are truncated to the precision of the format.
+
+\param pf The destination format.
+\param c Array of RGBA pixels.
+\param n The number of pixels.
+\param dp Pointer to the first destination pixel.
+*/
+static void _packPixelsPacked(const tPackedFormat *pf, const tColorRGBA *c, int n, Uint8 *dp)
+{
+	int i;
+	Uint32 v;
+	SDL_PixelFormat *f;
+
+	switch (pf->layout) {
+	case PACKED_RGB565:
+		for (i = 0; i < n; i++) {
+			((Uint16 *)dp)[i] = (Uint16)(((c[i].r & 0xf8) << 8) | ((c[i].g & 0xfc) << 3) | (c[i].b >> 3));
+		}
+		break;
+	case PACKED_RGB555:
+		for (i = 0; i < n; i++) {
+			((Uint16 *)dp)[i] = (Uint16)(((c[i].r & 0xf8) << 7) | ((c[i].g & 0xf8) << 2) | (c[i].b >> 3));
+		}
+		break;
+	case PACKED_RGB24:
+		for (i = 0; i < n; i++) {
+			dp[pf->offset[0]] = c[i].r;
+			dp[pf->offset[1]] = c[i].g;
+			dp[pf->offset[2]] = c[i].b;
+			dp += 3;
+		}
+		break;
+	default:
+		f = pf->format;
+		for (i = 0; i < n; i++) {
+			v = ((((Uint32)c[i].r >> f->Rloss) << f->Rshift) & f->Rmask) |
+				((((Uint32)c[i].g >> f->Gloss) << f->Gshift) & f->Gmask) |
+				((((Uint32)c[i].b >> f->Bloss) << f->Bshift) & f->Bmask) |
+				((((Uint32)c[i].a >> f->Aloss) << f->Ashift) & f->Amask);
+			_putPixelPacked(dp, pf->bpp, v);
+			dp += pf->bpp;
+		}
+		break;
+	}
+}
+
+/*!
+\brief Internal helper which copies packed 16 or 24 bit pixels without conversion.
+
+\param bpp Bytes per pixel (2 or 3).
+\param base Base pointer of the source pixels.
+\param offset Array of byte offsets of the source pixels.
+\param n The number of pixels.
+\param dp Pointer to the first destination pixel.
+*/
+static void _copyPixelsPacked(int bpp, const Uint8 *base, const int *offset, int n, Uint8 *dp)
+{
+	int i;
+	const Uint8 *p;
+
+	if (bpp == 2) {
+		for (i = 0; i < n; i++) {
+			((Uint16 *)dp)[i] = *(const Uint16 *)(base + offset[i]);
+		}
+	} else {
+		for (i = 0; i < n; i++) {
+			p = base + offset[i];
+			dp[0] = p[0];
+			dp[1] = p[1];
+			dp[2] = p[2];
+			dp += 3;
+		}
+	}
+}
+
+/*!
+\brief Internal helper for bilinear interpolation of arrays of 32 bit RGBA pixels.
+
+Uses the same arithmetic as the 32 bit transformers.
+
+\param c00 The upper left source pixels.
+\param c01 The upper right source pixels.
+\param c10 The lower left source pixels.
+\param c11 The lower right source pixels.
+\param ex The horizontal 16 bit fractions.
+\param ey The vertical 16 bit fractions.
+\param n The number of pixels.
+\param smooth Smoothing flags; SMOOTHING_PREMULTIPLIED and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
+\param dp Array receiving the interpolated pixels.
+*/
+static void _interpolatePixelsRGBA(const tColorRGBA *c00, const tColorRGBA *c01, const tColorRGBA *c10, const tColorRGBA *c11, 
+	const int *ex, const int *ey, int n, int smooth, tColorRGBA *dp)
+{
+	int i, t1, t2;
+
+	if (smooth & SMOOTHING_PREMULTIPLIED_MASK) {
+		for (i = 0; i < n; i++) {
+			_interpolatePremultiplied(c00[i], c01[i], c10[i], c11[i], ex[i], ey[i], 
+				(smooth & SMOOTHING_PREMULTIPLIED_OUTPUT), &dp[i]);
+		}
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		t1 = ((((c01[i].r - c00[i].r) * ex[i]) >> 16) + c00[i].r) & 0xff;
+		t2 = ((((c11[i].r - c10[i].r) * ex[i]) >> 16) + c10[i].r) & 0xff;
+		dp[i].r = (((t2 - t1) * ey[i]) >> 16) + t1;
+		t1 = ((((c01[i].g - c00[i].g) * ex[i]) >> 16) + c00[i].g) & 0xff;
+		t2 = ((((c11[i].g - c10[i].g) * ex[i]) >> 16) + c10[i].g) & 0xff;
+		dp[i].g = (((t2 - t1) * ey[i]) >> 16) + t1;
+		t1 = ((((c01[i].b - c00[i].b) * ex[i]) >> 16) + c00[i].b) & 0xff;
+		t2 = ((((c11[i].b - c10[i].b) * ex[i]) >> 16) + c10[i].b) & 0xff;
+		dp[i].b = (((t2 - t1) * ey[i]) >> 16) + t1;
+		t1 = ((((c01[i].a - c00[i].a) * ex[i]) >> 16) + c00[i].a) & 0xff;
+		t2 = ((((c11[i].a - c10[i].a) * ex[i]) >> 16) + c10[i].a) & 0xff;
+		dp[i].a = (((t2 - t1) * ey[i]) >> 16) + t1;
+	}
+}
+
+/*! 
+\brief Internal 16 or 24 bit Zoomer with optional anti-aliasing by bilinear interpolation.
+
+Zooms packed 16 bit (e.g. RGB565/RGB555) or 24 bit 'src' surface to 'dst' surface 
+without conversion of the whole surface to 32 bit. Samples the same source positions 
+as _zoomSurfaceRGBA(). Smoothing converts chunks of PACKED_CHUNK_SIZE pixels to 
+32 bit RGBA, interpolates them like the 32 bit zoomer and packs the result.
+Assumes src and dst surfaces are of the same format.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to zoom (input).
+\param dst The zoomed surface (output).
+\param flipx Flag indicating if the image should be horizontally flipped.
+\param flipy Flag indicating if the image should be vertically flipped.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. SMOOTHING_PREMULTIPLIED and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
+
+\return 0 for success or -1 for error.
+*/
+static int _zoomSurfacePacked(SDL_Surface * src, SDL_Surface * dst, int flipx, int flipy, int smooth)
+{
+	int x, y, i, n, *sax, *say, *xoff, cx, cx1, cy, cy1, spixelw, spixelh, bpp;
+	int ey[PACKED_CHUNK_SIZE];
+	tColorRGBA c00[PACKED_CHUNK_SIZE], c01[PACKED_CHUNK_SIZE], c10[PACKED_CHUNK_SIZE], c11[PACKED_CHUNK_SIZE];
+	tColorRGBA c[PACKED_CHUNK_SIZE];
+	tPackedFormat pf;
+	Uint8 *srow0, *srow1, *dp;
+
+	_packedFormat(src->format, &pf);
+	bpp = pf.bpp;
+
+	/*
+	* Allocate memory for row/column increments and the horizontal
+	* source offsets and fractions
+	*/
+	if ((sax = (int *) malloc((dst->w + 1) * sizeof(int))) == NULL) {
+		return (-1);
+	}
+	if ((say = (int *) malloc((dst->h + 1) * sizeof(int))) == NULL) {
+		free(sax);
+		return (-1);
+	}
+	if ((xoff = (int *) malloc(3 * dst->w * sizeof(int))) == NULL) {
+		free(sax);
+		free(say);
+		return (-1);
+	}
+
+	/*
+	* Precalculate row increments and column offsets
+	*/
+	spixelw = (src->w - 1);
+	spixelh = (src->h - 1);
+	_zoomSampleTable(src->w, dst->w, smooth, sax);
+	_zoomSampleTable(src->h, dst->h, smooth, say);
+	for (x = 0; x < dst->w; x++) {
+		cx = sax[x] >> 16;
+		cx1 = (smooth && (cx < spixelw)) ? cx + 1 : cx;
+		if (flipx) {
+			cx = spixelw - cx;
+			cx1 = spixelw - cx1;
+		}
+		xoff[x] = cx * bpp;
+		xoff[dst->w + x] = cx1 * bpp;
+		xoff[2 * dst->w + x] = sax[x] & 0xffff;
+	}
+
+	/*
+	* Scan destination
+	*/
+	for (y = 0; y < dst->h; y++) {
+		cy = say[y] >> 16;
+		cy1 = (smooth && (cy < spixelh)) ? cy + 1 : cy;
+		if (flipy) {
+			cy = spixelh - cy;
+			cy1 = spixelh - cy1;
+		}
+		srow0 = (Uint8 *)src->pixels + cy * src->pitch;
+		srow1 = (Uint8 *)src->pixels + cy1 * src->pitch;
+		dp = (Uint8 *)dst->pixels + y * dst->pitch;
+		if (!smooth) {
+			_copyPixelsPacked(bpp, srow0, xoff, dst->w, dp);
+			continue;
+		}
+		for (i = 0; i < PACKED_CHUNK_SIZE; i++) {
+			ey[i] = say[y] & 0xffff;
+		}
+		for (x = 0; x < dst->w; x += n) {
+			n = MIN(PACKED_CHUNK_SIZE, dst->w - x);
+			_unpackPixelsPacked(&pf, srow0, xoff + x, n, c00);
+			_unpackPixelsPacked(&pf, srow0, xoff + dst->w + x, n, c01);
+			_unpackPixelsPacked(&pf, srow1, xoff + x, n, c10);
+			_unpackPixelsPacked(&pf, srow1, xoff + dst->w + x, n, c11);
+			_interpolatePixelsRGBA(c00, c01, c10, c11, xoff + 2 * dst->w + x, ey, n, smooth, c);
+			_packPixelsPacked(&pf, c, n, dp);
+			dp += n * bpp;
+		}
+	}
+
+	/*
+	* Remove temp arrays 
+	*/
+	free(sax);
+	free(say);
+	free(xoff);
+
+	return (0);
+}
+
+/*! 
+\brief Internal 16 or 24 bit rotozoomer with optional anti-aliasing.
+
+Rotates and zooms packed 16 bit or 24 bit 'src' surface to 'dst' surface without 
+conversion of the whole surface to 32 bit, using the same source positions as 
+_transformSurfaceRGBA(). Source pixels are read in chunks of PACKED_CHUNK_SIZE 
+pixels; smoothing converts them to 32 bit RGBA and interpolates them like the 
+32 bit transformer. 'dst' either has the format of 'src' or is a 32 bit RGBA 
+surface (byte order R, G, B, A in memory). Areas not covered by the source are 
+set to the colorkey of the source or, for a 32 bit destination, to transparent black.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src Source surface.
+\param dst Destination surface.
+\param cx Horizontal center coordinate.
+\param cy Vertical center coordinate.
+\param isin Integer version of sine of angle.
+\param icos Integer version of cosine of angle.
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+\param smooth Flag indicating anti-aliasing should be used. SMOOTHING_PREMULTIPLIED and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
+*/
+static void _transformSurfacePacked(SDL_Surface * src, SDL_Surface * dst, int cx, int cy, int isin, int icos, int flipx, int flipy, int smooth)
+{
+	int x, y, i, n, dx, dy, xd, yd, sdx, sdy, ax, ay, sw, sh, xs, xe, lox, hix, loy, hiy;
+	int bpp, dbpp, ox0, ox1, oy0, oy1;
+	int offset[PACKED_CHUNK_SIZE], ex[PACKED_CHUNK_SIZE], ey[PACKED_CHUNK_SIZE];
+	tColorRGBA c00[PACKED_CHUNK_SIZE], c01[PACKED_CHUNK_SIZE], c10[PACKED_CHUNK_SIZE], c11[PACKED_CHUNK_SIZE];
+	tColorRGBA c[PACKED_CHUNK_SIZE];
+	tPackedFormat pf;
+	Uint32 key;
+	Uint8 *sp, *pc;
+
+	_packedFormat(src->format, &pf);
+	bpp = pf.bpp;
+	dbpp = dst->format->BytesPerPixel;
+
+	/*
+	* Variable setup 
+	*/
+	xd = ((src->w - dst->w) << 15);
+	yd = ((src->h - dst->h) << 15);
+	ax = (cx << 16) - (icos * cx);
+	ay = (cy << 16) - (isin * cx);
+	sw = src->w - 1;
+	sh = src->h - 1;
+	if (smooth) {
+		lox = (flipx) ? 1 : 0;
+		hix = (flipx) ? sw : sw - 1;
+		loy = (flipy) ? 1 : 0;
+		hiy = (flipy) ? sh : sh - 1;
+	} else {
+		lox = 0;
+		hix = sw;
+		loy = 0;
+		hiy = sh;
+	}
+
+	/*
+	* Offsets of the interpolated neighbor pixels; mirrored
+	* coordinates use the pixels to the left and above
+	*/
+	ox0 = (flipx) ? bpp : 0;
+	ox1 = bpp - ox0;
+	oy0 = (flipy) ? src->pitch : 0;
+	oy1 = src->pitch - oy0;
+
+	/*
+	* Clear surface to colorkey or transparent black
+	*/ 	
+	key = _colorkey(src);
+	for (y = 0; y < dst->h; y++) {
+		pc = (Uint8 *)dst->pixels + y * dst->pitch;
+		if (dbpp == 4) {
+			memset(pc, 0, dst->w * 4);
+			continue;
+		}
+		for (x = 0; x < dst->w; x++) {
+			_putPixelPacked(pc, bpp, key);
+			pc += bpp;
+		}
+	}
+
+	/*
+	* Iterate through the valid span of each destination row in chunks
+	*/
+	sp = (Uint8 *)src->pixels;
+	for (y = 0; y < dst->h; y++) {
+		dy = cy - y;
+		sdx = (ax + (isin * dy)) + xd;
+		sdy = (ay - (icos * dy)) + yd;
+		xs = 0;
+		xe = dst->w;
+		_transformClipSpan(sdx, icos, lox, hix, &xs, &xe);
+		_transformClipSpan(sdy, isin, loy, hiy, &xs, &xe);
+		sdx += icos * xs;
+		sdy += isin * xs;
+		pc = (Uint8 *)dst->pixels + y * dst->pitch + xs * dbpp;
+		for (x = xs; x < xe; x += n) {
+			n = MIN(PACKED_CHUNK_SIZE, xe - x);
+			for (i = 0; i < n; i++) {
+				dx = (sdx >> 16);
+				dy = (sdy >> 16);
+				if (flipx) dx = sw - dx;
+				if (flipy) dy = sh - dy;
+				offset[i] = src->pitch * dy + dx * bpp;
+				ex[i] = (sdx & 0xffff);
+				ey[i] = (sdy & 0xffff);
+				sdx += icos;
+				sdy += isin;
+			}
+			if (smooth) {
+				_unpackPixelsPacked(&pf, sp + ox0 + oy0, offset, n, c00);
+				_unpackPixelsPacked(&pf, sp + ox1 + oy0, offset, n, c01);
+				_unpackPixelsPacked(&pf, sp + ox0 + oy1, offset, n, c10);
+				_unpackPixelsPacked(&pf, sp + ox1 + oy1, offset, n, c11);
+				_interpolatePixelsRGBA(c00, c01, c10, c11, ex, ey, n, smooth, c);
+			} else if (dbpp == 4) {
+				_unpackPixelsPacked(&pf, sp, offset, n, c);
+			} else {
+				_copyPixelsPacked(bpp, sp, offset, n, pc);
+			}
+			if (dbpp == 4) {
+				memcpy(pc, c, n * 4);
+			} else if (smooth) {
+				_packPixelsPacked(&pf, c, n, pc);
+			}
+			pc += n * dbpp;
+		}
+	}
+}
+
+/*! 
+\brief Internal 16 or 24 bit integer-factor averaging shrinker.
+
+Shrinks packed 16 bit or 24 bit 'src' surface to 'dst' surface without conversion
+of the whole surface to 32 bit by averaging each channel over the source box. 
+Source rows are converted in chunks of PACKED_CHUNK_SIZE pixels and accumulated 
+per destination pixel.
+Assumes src and dst surfaces are of the same format.
+Assumes dst surface was allocated with the correct dimensions.
+
+\param src The surface to shrink (input).
+\param dst The shrunken surface (output).
+\param factorx The horizontal shrinking ratio.
+\param factory The vertical shrinking ratio.
+
+\return 0 for success or -1 for error.
+*/
+static int _shrinkSurfacePacked(SDL_Surface * src, SDL_Surface * dst, int factorx, int factory)
+{
+	int x, y, dy, i, n, sx, swidth, count, n_average;
+	int offset[PACKED_CHUNK_SIZE];
+	Uint32 *sum, *s;
+	tColorRGBA c[PACKED_CHUNK_SIZE];
+	tPackedFormat pf;
+	Uint8 *sp, *dp;
+
+	_packedFormat(src->format, &pf);
+	n_average = factorx * factory;
+	swidth = dst->w * factorx;
+	for (i = 0; i < PACKED_CHUNK_SIZE; i++) {
+		offset[i] = i * pf.bpp;
+	}
+
+	/*
+	* Allocate memory for the channel sums of a destination row
+	*/
+	if ((sum = (Uint32 *) malloc(dst->w * 4 * sizeof(Uint32))) == NULL) {
+		return (-1);
+	}
+
+	for (y = 0; y < dst->h; y++) {
+		/* Accumulate the source rows of the boxes */
+		memset(sum, 0, dst->w * 4 * sizeof(Uint32));
+		for (dy = 0; dy < factory; dy++) {
+			sp = (Uint8 *)src->pixels + (y * factory + dy) * src->pitch;
+			s = sum;
+			count = 0;
+			for (sx = 0; sx < swidth; sx += n) {
+				n = MIN(PACKED_CHUNK_SIZE, swidth - sx);
+				_unpackPixelsPacked(&pf, sp + sx * pf.bpp, offset, n, c);
+				for (i = 0; i < n; i++) {
+					s[0] += c[i].r;
+					s[1] += c[i].g;
+					s[2] += c[i].b;
+					s[3] += c[i].a;
+					if (++count == factorx) {
+						count = 0;
+						s += 4;
+					}
+				}
+			}
+		}
+
+		/* Store averages in destination */
+		dp = (Uint8 *)dst->pixels + y * dst->pitch;
+		for (x = 0; x < dst->w; x += n) {
+			n = MIN(PACKED_CHUNK_SIZE, dst->w - x);
+			s = sum + 4 * x;
+			for (i = 0; i < n; i++) {
+				c[i].r = (Uint8)(s[0] / n_average);
+				c[i].g = (Uint8)(s[1] / n_average);
+				c[i].b = (Uint8)(s[2] / n_average);
+				c[i].a = (Uint8)(s[3] / n_average);
+				s += 4;
+			}
+			_packPixelsPacked(&pf, c, n, dp);
+			dp += n * pf.bpp;
+		}
+	}
+
+	free(sum);
+
+	return (0);
+}
+
+/*!
+\brief Number of destination pixels for which source coordinates are calculated at once by the warp transformer.
+*/
+#define WARP_CHUNK_SIZE 64
+
+/*!
+\brief Internal helper which calculates source positions for a run of destination pixels.
+
+Evaluates the mapping of 'n' consecutive destination pixels of a row in floating
+point (SSE2 if available). For an affine mapping the source position of pixel x is 
+(bx + m[0] * x, by + m[3] * x); for a perspective mapping it is 
+((bx + m[0] * x) / (bw + m[6] * x), (by + m[3] * x) / (bw + m[6] * x)).
+Pixels which map outside the source surface (pixel centers at integer coordinates,
+i.e. the source covers [-0.5, w-0.5) x [-0.5, h-0.5)) or behind the projection
+center are flagged invalid. For smoothing, the coordinates are clamped to the edge
+pixels and split into integer part and 16 bit fraction; without smoothing they are
+rounded to the nearest pixel.
+
+\param m The 2x3 affine or 3x3 perspective matrix (row major).
+\param perspective Flag indicating 'm' is a 3x3 perspective matrix.
+\param bx Source x coordinate (numerator) of the first pixel.
+\param by Source y coordinate (numerator) of the first pixel.
+\param bw Denominator of the first pixel (perspective only).
+\param n Number of pixels (at most WARP_CHUNK_SIZE).
+\param sw Source surface width.
+\param sh Source surface height.
+\param smooth Flag indicating bilinear interpolation is used.
+\param ix Array receiving the integer source x coordinates.
+\param iy Array receiving the integer source y coordinates.
+\param fx Array receiving the 16 bit fractions of the source x coordinates.
+\param fy Array receiving the 16 bit fractions of the source y coordinates.
+\param valid Array receiving nonzero for pixels which map into the source.
+*/
+static void _warpSourcePositions(const double *m, int perspective, double bx, double by, double bw, int n, int sw, int sh, int smooth,
+	int *ix, int *iy, int *fx, int *fy, int *valid)
+{
+	int x;
+	float fsx, fsy, fsw, xmax, ymax, xlim, ylim;
+#ifdef USE_SSE2_ROTOZOOM
+	__m128 vsx, vsy, vsw, vbx, vby, vbw, vm0, vm3, vm6, vx, vfour, vlo, vxlim, vylim, vzero, vxmax, vymax, vhalf, vscale, vmask;
+	__m128i vix, viy;
+#endif
+
+	xlim = (float)sw - 0.5f;
+	ylim = (float)sh - 0.5f;
+	xmax = (float)(sw - 1);
+	ymax = (float)(sh - 1);
+	x = 0;
+#ifdef USE_SSE2_ROTOZOOM
+	vbx = _mm_set1_ps((float)bx);
+	vby = _mm_set1_ps((float)by);
+	vbw = _mm_set1_ps((float)bw);
+	vm0 = _mm_set1_ps((float)m[0]);
+	vm3 = _mm_set1_ps((float)m[3]);
+	vm6 = _mm_set1_ps((perspective) ? (float)m[6] : 0.0f);
+	vx = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+	vfour = _mm_set1_ps(4.0f);
+	vlo = _mm_set1_ps(-0.5f);
+	vxlim = _mm_set1_ps(xlim);
+	vylim = _mm_set1_ps(ylim);
+	vzero = _mm_setzero_ps();
+	vxmax = _mm_set1_ps(xmax);
+	vymax = _mm_set1_ps(ymax);
+	vhalf = _mm_set1_ps(0.5f);
+	vscale = _mm_set1_ps(65536.0f);
+	for (; x + 4 <= n; x += 4) {
+		vsx = _mm_add_ps(vbx, _mm_mul_ps(vm0, vx));
+		vsy = _mm_add_ps(vby, _mm_mul_ps(vm3, vx));
+		if (perspective) {
+			vsw = _mm_add_ps(vbw, _mm_mul_ps(vm6, vx));
+			vmask = _mm_cmpgt_ps(vsw, vzero);
+			vsw = _mm_or_ps(_mm_and_ps(vmask, vsw), _mm_andnot_ps(vmask, _mm_set1_ps(1.0f)));
+			vsx = _mm_div_ps(vsx, vsw);
+			vsy = _mm_div_ps(vsy, vsw);
+		} else {
+			vmask = _mm_cmpeq_ps(vzero, vzero);
+		}
+		vx = _mm_add_ps(vx, vfour);
+		vmask = _mm_and_ps(vmask, _mm_and_ps(_mm_cmpge_ps(vsx, vlo), _mm_cmplt_ps(vsx, vxlim)));
+		vmask = _mm_and_ps(vmask, _mm_and_ps(_mm_cmpge_ps(vsy, vlo), _mm_cmplt_ps(vsy, vylim)));
+		_mm_storeu_si128((__m128i *)(valid + x), _mm_castps_si128(vmask));
+		if (smooth) {
+			vsx = _mm_min_ps(_mm_max_ps(vsx, vzero), vxmax);
+			vsy = _mm_min_ps(_mm_max_ps(vsy, vzero), vymax);
+			vix = _mm_cvttps_epi32(vsx);
+			viy = _mm_cvttps_epi32(vsy);
+			_mm_storeu_si128((__m128i *)(fx + x), _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(vsx, _mm_cvtepi32_ps(vix)), vscale)));
+			_mm_storeu_si128((__m128i *)(fy + x), _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(vsy, _mm_cvtepi32_ps(viy)), vscale)));
+		} else {
+			vix = _mm_cvttps_epi32(_mm_add_ps(vsx, vhalf));
+			viy = _mm_cvttps_epi32(_mm_add_ps(vsy, vhalf));
+		}
+		_mm_storeu_si128((__m128i *)(ix + x), vix);
+		_mm_storeu_si128((__m128i *)(iy + x), viy);
+	}
+#endif
+	for (; x < n; x++) {
+		fsx = (float)bx + (float)m[0] * (float)x;
+		fsy = (float)by + (float)m[3] * (float)x;
+		if (perspective) {
+			fsw = (float)bw + (float)m[6] * (float)x;
+			if (!(fsw > 0.0f)) {
+				valid[x] = 0;
+				continue;
+			}
+			fsx /= fsw;
+			fsy /= fsw;
+		}
+		valid[x] = (fsx >= -0.5f) && (fsx < xlim) && (fsy >= -0.5f) && (fsy < ylim);
+		if (!valid[x]) {
+			continue;
+		}
+		if (smooth) {
+			if (fsx < 0.0f) fsx = 0.0f;
+			if (fsx > xmax) fsx = xmax;
+			if (fsy < 0.0f) fsy = 0.0f;
+			if (fsy > ymax) fsy = ymax;
+			ix[x] = (int)fsx;
+			iy[x] = (int)fsy;
+			fx[x] = (int)((fsx - (float)ix[x]) * 65536.0f);
+			fy[x] = (int)((fsy - (float)iy[x]) * 65536.0f);
+		} else {
+			ix[x] = (int)(fsx + 0.5f);
+			iy[x] = (int)(fsy + 0.5f);
+		}
+	}
+}
+
+/*!
+\brief Internal floating point affine or perspective transformer for 32 bit and 8 bit surfaces.
+
+Transforms 'src' into 'dst' by mapping each destination pixel (x,y) to the source
+position (m[0]*x + m[1]*y + m[2], m[3]*x + m[4]*y + m[5]) for an affine mapping, or
+to that position divided by m[6]*x + m[7]*y + m[8] for a perspective mapping, 
+where integer coordinates are pixel centers. Source positions are calculated per 
+pixel from the matrix instead of being accumulated in fixed point, so there is no
+drift across wide surfaces, and edges are handled exactly (clamped to the edge 
+pixels), so no reads outside the source surface occur and no guard rows are required.
+Each row only depends on the matrix, so rows can be processed in any order.
+Destination pixels which map outside the source are left untouched (32 bit) or
+set to the colorkey (8 bit).
+32 bit surfaces can be smoothed by bilinear interpolation; 8 bit surfaces are 
+always sampled from the nearest pixel.
+
+\param src Source surface (8 or 32 bit).
+\param dst Destination surface (same depth as the source).
+\param m The 2x3 affine or 3x3 perspective matrix mapping destination to source coordinates (row major).
+\param perspective Flag indicating 'm' is a 3x3 perspective matrix.
+\param smooth Flag indicating anti-aliasing should be used (32 bit only). SMOOTHING_PREMULTIPLIED and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
+*/
+static void _transformSurfaceWarp(SDL_Surface * src, SDL_Surface * dst, const double *m, int perspective, int smooth)
+{
+	int x, y, i, n, t1, t2, ex, ey, sw, sh, x1, y1;
+	int ix[WARP_CHUNK_SIZE], iy[WARP_CHUNK_SIZE], fx[WARP_CHUNK_SIZE], fy[WARP_CHUNK_SIZE], valid[WARP_CHUNK_SIZE];
+	int is32bit, premultiplied, premultipliedout;
+	double bx, by, bw;
+	tColorRGBA c00, c01, c10, c11;
+	tColorRGBA *pc, *sp0, *sp1;
+	Uint8 *pcy;
+
+	is32bit = (src->format->BitsPerPixel == 32);
+	if (!is32bit) {
+		smooth = 0;
+		/*
+		* Clear surface to colorkey 
+		*/ 	
+		memset(dst->pixels, (int)(_colorkey(src) & 0xff), dst->pitch * dst->h);
+	}
+	sw = src->w - 1;
+	sh = src->h - 1;
+	premultiplied = (smooth & SMOOTHING_PREMULTIPLIED_MASK);
+	premultipliedout = (smooth & SMOOTHING_PREMULTIPLIED_OUTPUT);
+
+	for (y = 0; y < dst->h; y++) {
+		for (x = 0; x < dst->w; x += WARP_CHUNK_SIZE) {
+			n = MIN(WARP_CHUNK_SIZE, dst->w - x);
+			bx = m[0] * (double)x + m[1] * (double)y + m[2];
+			by = m[3] * (double)x + m[4] * (double)y + m[5];
+			bw = (perspective) ? m[6] * (double)x + m[7] * (double)y + m[8] : 1.0;
+			_warpSourcePositions(m, perspective, bx, by, bw, n, src->w, src->h, smooth, ix, iy, fx, fy, valid);
+
+			if (!is32bit) {
+				pcy = (Uint8 *)dst->pixels + dst->pitch * y + x;
+				for (i = 0; i < n; i++) {
+					if (valid[i]) {
+						pcy[i] = *((Uint8 *)src->pixels + src->pitch * iy[i] + ix[i]);
+					}
+				}
+				continue;
+			}
+
+			pc = (tColorRGBA *) ((Uint8 *)dst->pixels + dst->pitch * y);
+			pc += x;
+			if (smooth) {
+				for (i = 0; i < n; i++) {
+					if (valid[i]) {
+						x1 = (ix[i] < sw) ? 1 : 0;
+						y1 = (iy[i] < sh) ? src->pitch : 0;
+						sp0 = (tColorRGBA *) ((Uint8 *)src->pixels + src->pitch * iy[i]);
+						sp0 += ix[i];
+						sp1 = (tColorRGBA *) ((Uint8 *)sp0 + y1);
+						c00 = sp0[0];
+						c01 = sp0[x1];
+						c10 = sp1[0];
+						c11 = sp1[x1];
+						/*
+						* Interpolate colors 
+						*/
+						ex = fx[i];
+						ey = fy[i];
+						if (premultiplied) {
+							_interpolatePremultiplied(c00, c01, c10, c11, ex, ey, premultipliedout, &pc[i]);
+						} else {
+							t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
+							t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
+							pc[i].r = (((t2 - t1) * ey) >> 16) + t1;
+							t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
+							t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
+							pc[i].g = (((t2 - t1) * ey) >> 16) + t1;
+							t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
+							t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
+							pc[i].b = (((t2 - t1) * ey) >> 16) + t1;
+							t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
+							t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
+							pc[i].a = (((t2 - t1) * ey) >> 16) + t1;
+						}
+					}
+				}
+			} else {
+				for (i = 0; i < n; i++) {
+					if (valid[i]) {
+						sp0 = (tColorRGBA *) ((Uint8 *)src->pixels + src->pitch * iy[i]);
+						pc[i] = sp0[ix[i]];
+					}
+				}
+			}
+		}
+	}
+}
+
+/*!
+\brief Internal helper which sets up the affine matrix of a rotozoom or zoom for the floating point transformer.
+
+Maps the destination pixel centers back to the source using the same geometry as 
+the fixed point rotozoomer: the destination center corresponds to the source center, 
+rotation by 'sangleinv'/'cangleinv' (sine and cosine of the angle divided by the
+zoom factor) or scaling to the destination size if there is no rotation.
+
+\param src Source surface.
+\param dst Destination surface.
+\param rotate Flag indicating a rotation; a plain zoom otherwise.
+\param sangleinv Sine of the angle divided by the zoom (rotation only).
+\param cangleinv Cosine of the angle divided by the zoom (rotation only).
+\param flipx Flag indicating horizontal mirroring should be applied.
+\param flipy Flag indicating vertical mirroring should be applied.
+\param m Array of 6 doubles receiving the matrix.
+*/
+static void _rotozoomAffineMatrix(SDL_Surface * src, SDL_Surface * dst, int rotate, double sangleinv, double cangleinv, 
+	int flipx, int flipy, double *m)
+{
+	double u0, v0;
+
+	if (rotate) {
+		/* Destination pixel center relative to the destination center */
+		u0 = 0.5 - (double)dst->w / 2.0;
+		v0 = 0.5 - (double)dst->h / 2.0;
+		m[0] = cangleinv;
+		m[1] = -sangleinv;
+		m[2] = cangleinv * u0 - sangleinv * v0 + (double)src->w / 2.0 - 0.5;
+		m[3] = sangleinv;
+		m[4] = cangleinv;
+		m[5] = sangleinv * u0 + cangleinv * v0 + (double)src->h / 2.0 - 0.5;
+	} else {
+		m[0] = (double)src->w / (double)dst->w;
+		m[1] = 0.0;
+		m[2] = 0.5 * m[0] - 0.5;
+		m[3] = 0.0;
+		m[4] = (double)src->h / (double)dst->h;
+		m[5] = 0.5 * m[4] - 0.5;
+	}
+
+	/* Mirror source coordinates */
+	if (flipx) {
+		m[0] = -m[0];
+		m[1] = -m[1];
+		m[2] = (double)(src->w - 1) - m[2];
+	}
+	if (flipy) {
+		m[3] = -m[3];
+		m[4] = -m[4];
+		m[5] = (double)(src->h - 1) - m[5];
+	}
+}
+
+/*!
+\brief Internal helper which copies one source tile of a 90 degree rotation.
+
+Source pixel (row, col) of the tile is written to dbase + row * rstep + col * cstep,
+which covers both rotation directions. Uses typed copies for 8/16/24/32 bit pixels
+and SSE2 4x4 transposes for 32 bit pixels if available.
+
+\param sbase Pointer to the first source pixel of the tile.
+\param spitch The pitch of the source surface.
+\param dbase Pointer to the destination of the first source pixel of the tile.
+\param rstep Destination byte offset per source row.
+\param cstep Destination byte offset per source column.
+\param bpp Bytes per pixel (1 to 4).
+\param rows Number of rows in the tile.
+\param cols Number of columns in the tile.
+*/
+static void _rotateTile90Degrees(Uint8 *sbase, int spitch, Uint8 *dbase, int rstep, int cstep, int bpp, int rows, int cols)
+{
+	int row, col;
+	Uint8 *sp, *dp;
+#ifdef USE_SSE2_ROTOZOOM
+	__m128i a, b, c, d, t0, t1, t2, t3;
+	int rowoffset, reverse;
+#endif
+
+	row = 0;
+	switch (bpp) {
+	case 1:
+		for (; row < rows; row++) {
+			sp = sbase + row * spitch;
+			dp = dbase + row * rstep;
+			for (col = 0; col < cols; col++) {
+				*dp = sp[col];
+				dp += cstep;
+			}
+		}
+		break;
+	case 2:
+		for (; row < rows; row++) {
+			sp = sbase + row * spitch;
+			dp = dbase + row * rstep;
+			for (col = 0; col < cols; col++) {
+				*(Uint16 *)dp = ((Uint16 *)sp)[col];
+				dp += cstep;
+			}
+		}
+		break;
+	case 3:
+		for (; row < rows; row++) {
+			sp = sbase + row * spitch;
+			dp = dbase + row * rstep;
+			for (col = 0; col < cols; col++) {
+				dp[0] = sp[0];
+				dp[1] = sp[1];
+				dp[2] = sp[2];
+				sp += 3;
+				dp += cstep;
+			}
+		}
+		break;
+	case 4:
+#ifdef USE_SSE2_ROTOZOOM
+		/* 
+		* Transpose 4x4 blocks: 4 source rows are loaded and transposed into 
+		* 4 destination rows; if the destination runs backwards per source 
+		* row the transposed rows are reversed and stored at the last row 
+		*/
+		reverse = (rstep < 0);
+		rowoffset = (reverse) ? 3 * rstep : 0;
+		for (; row + 4 <= rows; row += 4) {
+			sp = sbase + row * spitch;
+			dp = dbase + row * rstep + rowoffset;
+			for (col = 0; col + 4 <= cols; col += 4) {
+				a = _mm_loadu_si128((__m128i *)(sp));
+				b = _mm_loadu_si128((__m128i *)(sp + spitch));
+				c = _mm_loadu_si128((__m128i *)(sp + 2 * spitch));
+				d = _mm_loadu_si128((__m128i *)(sp + 3 * spitch));
+				t0 = _mm_unpacklo_epi32(a, b);
+				t1 = _mm_unpacklo_epi32(c, d);
+				t2 = _mm_unpackhi_epi32(a, b);
+				t3 = _mm_unpackhi_epi32(c, d);
+				a = _mm_unpacklo_epi64(t0, t1);
+				b = _mm_unpackhi_epi64(t0, t1);
+				c = _mm_unpacklo_epi64(t2, t3);
+				d = _mm_unpackhi_epi64(t2, t3);
+				if (reverse) {
+					a = _mm_shuffle_epi32(a, _MM_SHUFFLE(0, 1, 2, 3));
+					b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 1, 2, 3));
+					c = _mm_shuffle_epi32(c, _MM_SHUFFLE(0, 1, 2, 3));
+					d = _mm_shuffle_epi32(d, _MM_SHUFFLE(0, 1, 2, 3));
+				}
+				_mm_storeu_si128((__m128i *)(dp), a);
+				_mm_storeu_si128((__m128i *)(dp + cstep), b);
+				_mm_storeu_si128((__m128i *)(dp + 2 * cstep), c);
+				_mm_storeu_si128((__m128i *)(dp + 3 * cstep), d);
+				sp += 16;
+				dp += 4 * cstep;
+			}
+			/* Remaining columns of these 4 rows */
+			for (; col < cols; col++) {
+				sp = sbase + row * spitch + col * 4;
+				dp = dbase + row * rstep + col * cstep;
+				*(Uint32 *)(dp) = *(Uint32 *)(sp);
+				*(Uint32 *)(dp + rstep) = *(Uint32 *)(sp + spitch);
+				*(Uint32 *)(dp + 2 * rstep) = *(Uint32 *)(sp + 2 * spitch);
+				*(Uint32 *)(dp + 3 * rstep) = *(Uint32 *)(sp + 3 * spitch);
+			}
+		}
+#endif
+		/* Remaining rows */
+		for (; row < rows; row++) {
+			sp = sbase + row * spitch;
+			dp = dbase + row * rstep;
+			for (col = 0; col < cols; col++) {
+				*(Uint32 *)dp = ((Uint32 *)sp)[col];
+				dp += cstep;
+			}
+		}
+		break;
+	}
+}
+
+/*!
+\brief Internal tiled 90 degree rotator.
+
+Rotates 'src' into 'dst' by copying source tiles of ROTATE90_TILE_SIZE x ROTATE90_TILE_SIZE 
+pixels, so both the source reads and the (transposed) destination writes stay within
+a small working set.
+Assumes dst surface was allocated with the correct (swapped) dimensions.
+
+\param src Source surface.
+\param dst Destination surface.
+\param clockwise Flag indicating a clockwise rotation; counter-clockwise otherwise.
+\param bpp Bytes per pixel of both surfaces.
+*/
+static void _rotateSurface90DegreesTiled(SDL_Surface * src, SDL_Surface * dst, int clockwise, int bpp)
+{
+	int row, col, rows, cols;
+	int rstep, cstep;
+	Uint8 *dbase;
+
+	if (clockwise) {
+		/* Source row becomes destination column from the right, source column becomes destination row */
+		dbase = (Uint8*)(dst->pixels) + (dst->w - 1) * bpp;
+		rstep = -bpp;
+		cstep = dst->pitch;
+	} else {
+		/* Source row becomes destination column, source column becomes destination row from the bottom */
+		dbase = (Uint8*)(dst->pixels) + (dst->h - 1) * dst->pitch;
+		rstep = bpp;
+		cstep = -dst->pitch;
+	}
+
+	for (row = 0; row < src->h; row += ROTATE90_TILE_SIZE) {
+		rows = MIN(ROTATE90_TILE_SIZE, src->h - row);
+		for (col = 0; col < src->w; col += ROTATE90_TILE_SIZE) {
+			cols = MIN(ROTATE90_TILE_SIZE, src->w - col);
+			_rotateTile90Degrees((Uint8*)(src->pixels) + row * src->pitch + col * bpp, src->pitch, 
+				dbase + row * rstep + col * cstep, rstep, cstep, bpp, rows, cols);
+		}
+	}
+}
+
+/*!
+\brief Rotates a 8/16/24/32 bit surface in increments of 90 degrees.
+
+Specialized 90 degree rotator which rotates a 'src' surface in 90 degree 
+increments clockwise returning a new surface. Faster than rotozoomer since
+no scanning or interpolation takes place. Input surface must be 8/16/24/32 bit.
+Quarter turns are done in cache sized tiles (with SSE2 4x4 transposes for 32 bit
+surfaces, if available).
+(code contributed by J. Schiller, improved by C. Allport and A. Schiffler)
+
+\param src Source surface to rotate.
+\param numClockwiseTurns Number of clockwise 90 degree turns to apply to the source.
+
+\returns The new, rotated surface; or NULL for surfaces with incorrect input format.
+*/
+SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns) 
+{
+	int row, col, newWidth, newHeight;
+	int bpp, bpr;
+	SDL_Surface* dst;
+	Uint8* srcBuf;
+	Uint8* dstBuf;
+	int normalizedClockwiseTurns;
+
+	/* Has to be a valid surface pointer and be a Nbit surface where n is divisible by 8 */
+	if (!src || 
+	    !src->format) {
+		SDL_SetError("NULL source surface or source surface format");
+	    return NULL; 
+	}
+
+	if ((src->format->BitsPerPixel % 8) != 0) {
+		SDL_SetError("Invalid source surface bit depth");
+	    return NULL; 
+	}
+
+	/* normalize numClockwiseTurns */
+	normalizedClockwiseTurns = (numClockwiseTurns % 4);
+	if (normalizedClockwiseTurns < 0) {
+		normalizedClockwiseTurns += 4;
+	}
+
+	/* If turns are even, our new width/height will be the same as the source surface */
+	if (normalizedClockwiseTurns % 2) {
+		newWidth = src->h;
+		newHeight = src->w;
+	} else {
+		newWidth = src->w;
+		newHeight = src->h;
+	}
+
+	dst = SDL_CreateRGBSurface( src->flags, newWidth, newHeight, src->format->BitsPerPixel,
+		src->format->Rmask,
+		src->format->Gmask, 
+		src->format->Bmask, 
+		src->format->Amask);
+	if(!dst) {
+		SDL_SetError("Could not create destination surface"); 
+		return NULL;
+	}
+
+	if (SDL_MUSTLOCK(src)) {
+		SDL_LockSurface(src);
+	}
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_LockSurface(dst);
+	}
+
+	/* Calculate byte-per-pixel */
+	bpp = src->format->BitsPerPixel / 8;
+
+	switch(normalizedClockwiseTurns) {
+	case 0: /* Make a copy of the surface */
 		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + (dst->w - row - 1) * bpp;
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
+			/* Unfortunately SDL_BlitSurface cannot be used to make a copy of the surface
+			since it does not preserve alpha. */
+
+			if (src->pitch == dst->pitch) {
+				/* If the pitch is the same for both surfaces, the memory can be copied all at once. */
+				memcpy(dst->pixels, src->pixels, (src->h * src->pitch));
+			}
+			else
+			{
+				/* If the pitch differs, copy each row separately */
+				srcBuf = (Uint8*)(src->pixels);
+				dstBuf = (Uint8*)(dst->pixels);
+				bpr = src->w * bpp;
+				for (row = 0; row < src->h; row++) {
+					memcpy(dstBuf, srcBuf, bpr);
+					srcBuf += src->pitch;
 					dstBuf += dst->pitch;
-				} 
-			} 
+				}
+			}
+		}
+		break;
+
+		/* rotate clockwise */
+	case 1: /* rotated 90 degrees clockwise */
+		{
+			_rotateSurface90DegreesTiled(src, dst, 1, bpp);
 		}
 		break;
 
@@ -912,15 +2677,7 @@ SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns)
 
 	case 3: /* rotated 270 degrees clockwise */
 		{
-			for (row = 0; row < src->h; ++row) {
-				srcBuf = (Uint8*)(src->pixels) + (row * src->pitch);
-				dstBuf = (Uint8*)(dst->pixels) + (row * bpp) + (dst->h * dst->pitch);
-				for (col = 0; col < src->w; ++col) {
-					memcpy (dstBuf, srcBuf, bpp);
-					srcBuf += bpp;
-					dstBuf -= dst->pitch;
-				} 
-			} 
+			_rotateSurface90DegreesTiled(src, dst, 0, bpp);
 		}
 		break;
 	} 
@@ -933,7 +2690,260 @@ SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns)
 		SDL_UnlockSurface(dst);
 	}
 
-	return dst;
+	return dst;
+}
+
+#ifdef USE_SSE2_ROTOZOOM
+/*!
+\brief Internal helper which reverses the order of the pixels in a SSE2 register.
+
+\param v The 16 bytes to reverse.
+\param bpp Bytes per pixel (1, 2 or 4).
+
+\returns The register with the pixel order reversed.
+*/
+static __m128i _reversePixelsSSE2(__m128i v, int bpp)
+{
+	if (bpp == 4) {
+		return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+	}
+	v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+	v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+	if (bpp == 1) {
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	}
+	return v;
+}
+#endif
+
+/*!
+\brief Internal helper which swaps two pixels of 1 to 4 bytes.
+
+\param a Pointer to the first pixel.
+\param b Pointer to the second pixel.
+\param bpp Bytes per pixel.
+*/
+static void _swapPixels(Uint8 *a, Uint8 *b, int bpp)
+{
+	Uint8 t8;
+	Uint16 t16;
+	Uint32 t32;
+
+	switch (bpp) {
+	case 1:
+		t8 = *a; *a = *b; *b = t8;
+		break;
+	case 2:
+		t16 = *(Uint16 *)a; *(Uint16 *)a = *(Uint16 *)b; *(Uint16 *)b = t16;
+		break;
+	case 3:
+		t8 = a[0]; a[0] = b[0]; b[0] = t8;
+		t8 = a[1]; a[1] = b[1]; b[1] = t8;
+		t8 = a[2]; a[2] = b[2]; b[2] = t8;
+		break;
+	case 4:
+		t32 = *(Uint32 *)a; *(Uint32 *)a = *(Uint32 *)b; *(Uint32 *)b = t32;
+		break;
+	}
+}
+
+/*!
+\brief Internal helper which mirrors a pair of rows in place.
+
+Swaps pixel i of row 'a' with pixel w-1-i of row 'b'. If both rows are the same
+the row is reversed in place.
+
+\param a Pointer to the first row.
+\param b Pointer to the second row (may be the same as the first).
+\param w Number of pixels per row.
+\param bpp Bytes per pixel.
+*/
+static void _mirrorRows(Uint8 *a, Uint8 *b, int w, int bpp)
+{
+	int i, n;
+#ifdef USE_SSE2_ROTOZOOM
+	__m128i va, vb;
+	int ppv, j;
+#endif
+
+	i = 0;
+	n = (a == b) ? w / 2 : w;
+#ifdef USE_SSE2_ROTOZOOM
+	if (bpp != 3) {
+		/* Swap and reverse vectors from the left of row a and the right of row b */
+		ppv = 16 / bpp;
+		for (;;) {
+			j = w - i - ppv;
+			if ((a == b) ? (i + ppv > j) : (j < 0)) {
+				break;
+			}
+			va = _mm_loadu_si128((__m128i *)(a + i * bpp));
+			vb = _mm_loadu_si128((__m128i *)(b + j * bpp));
+			_mm_storeu_si128((__m128i *)(a + i * bpp), _reversePixelsSSE2(vb, bpp));
+			_mm_storeu_si128((__m128i *)(b + j * bpp), _reversePixelsSSE2(va, bpp));
+			i += ppv;
+		}
+	}
+#endif
+	for (; i < n; i++) {
+		_swapPixels(a + i * bpp, b + (w - 1 - i) * bpp, bpp);
+	}
+}
+
+/*!
+\brief Internal helper which swaps the content of two rows.
+
+\param a Pointer to the first row.
+\param b Pointer to the second row.
+\param bytes Number of bytes to swap.
+*/
+static void _swapRows(Uint8 *a, Uint8 *b, int bytes)
+{
+	int i;
+	Uint8 t;
+#ifdef USE_SSE2_ROTOZOOM
+	__m128i va, vb;
+#endif
+
+	i = 0;
+#ifdef USE_SSE2_ROTOZOOM
+	for (; i + 16 <= bytes; i += 16) {
+		va = _mm_loadu_si128((__m128i *)(a + i));
+		vb = _mm_loadu_si128((__m128i *)(b + i));
+		_mm_storeu_si128((__m128i *)(a + i), vb);
+		_mm_storeu_si128((__m128i *)(b + i), va);
+	}
+#endif
+	for (; i < bytes; i++) {
+		t = a[i];
+		a[i] = b[i];
+		b[i] = t;
+	}
+}
+
+/*!
+\brief Internal helper which checks and locks a surface for in-place flipping.
+
+\param surface The surface to check and lock.
+
+\returns The bytes per pixel of the surface or -1 for surfaces with incorrect format.
+*/
+static int _lockFlipSurface(SDL_Surface *surface)
+{
+	if (!surface || 
+	    !surface->format) {
+		SDL_SetError("NULL surface or surface format");
+		return -1;
+	}
+
+	if (((surface->format->BitsPerPixel % 8) != 0) || (surface->format->BitsPerPixel == 0)) {
+		SDL_SetError("Invalid surface bit depth");
+		return -1;
+	}
+
+	if (SDL_MUSTLOCK(surface)) {
+		if (SDL_LockSurface(surface) < 0) {
+			return -1;
+		}
+	}
+
+	return surface->format->BitsPerPixel / 8;
+}
+
+/*!
+\brief Mirrors a 8/16/24/32 bit surface horizontally in place.
+
+Reverses the order of the pixels in each row of the surface. No memory is 
+allocated; 8/16/32 bit rows are reversed using SSE2 shuffles if available.
+
+\param surface The surface to flip.
+
+\returns 0 for success or -1 for surfaces with incorrect format.
+*/
+int flipSurfaceHorizontal(SDL_Surface* surface)
+{
+	int row, bpp;
+	Uint8 *buf;
+
+	if ((bpp = _lockFlipSurface(surface)) < 0) {
+		return -1;
+	}
+
+	for (row = 0; row < surface->h; row++) {
+		buf = (Uint8*)(surface->pixels) + row * surface->pitch;
+		_mirrorRows(buf, buf, surface->w, bpp);
+	}
+
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+
+	return 0;
+}
+
+/*!
+\brief Mirrors a 8/16/24/32 bit surface vertically in place.
+
+Swaps the rows of the surface top to bottom. No memory is allocated.
+
+\param surface The surface to flip.
+
+\returns 0 for success or -1 for surfaces with incorrect format.
+*/
+int flipSurfaceVertical(SDL_Surface* surface)
+{
+	int row, bpp;
+	Uint8 *top, *bottom;
+
+	if ((bpp = _lockFlipSurface(surface)) < 0) {
+		return -1;
+	}
+
+	for (row = 0; row < surface->h / 2; row++) {
+		top = (Uint8*)(surface->pixels) + row * surface->pitch;
+		bottom = (Uint8*)(surface->pixels) + (surface->h - 1 - row) * surface->pitch;
+		_swapRows(top, bottom, surface->w * bpp);
+	}
+
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+
+	return 0;
+}
+
+/*!
+\brief Rotates a 8/16/24/32 bit surface by 180 degrees in place.
+
+Mirrors the surface horizontally and vertically in a single pass over 
+the rows. No memory is allocated; 8/16/32 bit rows are reversed using 
+SSE2 shuffles if available.
+
+\param surface The surface to rotate.
+
+\returns 0 for success or -1 for surfaces with incorrect format.
+*/
+int rotateSurface180Degrees(SDL_Surface* surface)
+{
+	int row, bpp;
+	Uint8 *top, *bottom;
+
+	if ((bpp = _lockFlipSurface(surface)) < 0) {
+		return -1;
+	}
+
+	for (row = 0; row < (surface->h + 1) / 2; row++) {
+		top = (Uint8*)(surface->pixels) + row * surface->pitch;
+		bottom = (Uint8*)(surface->pixels) + (surface->h - 1 - row) * surface->pitch;
+		_mirrorRows(top, bottom, surface->w, bpp);
+	}
+
+	if (SDL_MUSTLOCK(surface)) {
+		SDL_UnlockSurface(surface);
+	}
+
+	return 0;
 }
 
 
@@ -1022,13 +3032,19 @@ void rotozoomSurfaceSize(int width, int height, double angle, double zoom, int *
 
 Rotates and zoomes a 32bit or 8bit 'src' surface to newly created 'dst' surface.
 'angle' is the rotation in degrees and 'zoom' a scaling factor. If 'smooth' is set
-then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+then the destination 32bit surface or 8bit surface with a grayscale palette is
+anti-aliased. 32bit and 8bit surfaces are returned in the source format.
+Packed 16bit (e.g. RGB565) and 24bit surfaces are returned in the source format if
+they are only zoomed or have a colorkey; areas a rotation leaves uncovered are set
+to the colorkey, which is copied to the result. Rotated packed surfaces without a
+colorkey, packed surfaces with SMOOTHING_SUBPIXEL and all other formats are returned
+as a 32bit RGBA surface with transparent uncovered areas. Note: earlier versions
+returned all packed surfaces as 32bit RGBA surfaces.
 
 \param src The surface to rotozoom.
 \param angle The angle to rotate in degrees.
 \param zoom The scaling factor.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. Add SMOOTHING_SUBPIXEL to use the floating point transformer. Add SMOOTHING_PREMULTIPLIED or SMOOTHING_PREMULTIPLIED_OUTPUT for alpha weighted smoothing of 32 bit surfaces.
 
 \return The new rotozoomed surface.
 */
@@ -1042,14 +3058,20 @@ SDL_Surface *rotozoomSurface(SDL_Surface * src, double angle, double zoom, int s
 
 Rotates and zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
 'angle' is the rotation in degrees, 'zoomx and 'zoomy' scaling factors. If 'smooth' is set
-then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+then the destination 32bit surface or 8bit surface with a grayscale palette is
+anti-aliased. 32bit and 8bit surfaces are returned in the source format.
+Packed 16bit (e.g. RGB565) and 24bit surfaces are returned in the source format if
+they are only zoomed or have a colorkey; areas a rotation leaves uncovered are set
+to the colorkey, which is copied to the result. Rotated packed surfaces without a
+colorkey, packed surfaces with SMOOTHING_SUBPIXEL and all other formats are returned
+as a 32bit RGBA surface with transparent uncovered areas. Note: earlier versions
+returned all packed surfaces as 32bit RGBA surfaces.
 
 \param src The surface to rotozoom.
 \param angle The angle to rotate in degrees.
 \param zoomx The horizontal scaling factor.
 \param zoomy The vertical scaling factor.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. Add SMOOTHING_SUBPIXEL to use the floating point transformer. Add SMOOTHING_PREMULTIPLIED or SMOOTHING_PREMULTIPLIED_OUTPUT for alpha weighted smoothing of 32 bit surfaces.
 
 \return The new rotozoomed surface.
 */
@@ -1060,9 +3082,12 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 	double zoominv;
 	double sanglezoom, canglezoom, sanglezoominv, canglezoominv;
 	int dstwidthhalf, dstwidth, dstheighthalf, dstheight;
-	int is32bit;
+	int is32bit, ispacked, packedrgba;
 	int i, src_converted;
 	int flipx,flipy;
+	int subpixel, guardrows;
+	Uint32 key;
+	double matrix[6];
 
 	/*
 	* Sanity check 
@@ -1072,10 +3097,24 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 	}
 
 	/*
-	* Determine if source surface is 32bit or 8bit 
+	* Split off transformer selection from smoothing flag; the floating
+	* point transformer does not need guard rows
+	*/
+	smooth = _smoothingFlags(smooth, &subpixel);
+	guardrows = (subpixel) ? 0 : GUARD_ROWS;
+
+	/*
+	* Determine if source surface is 32bit, 8bit or packed 16/24bit;
+	* the floating point transformer needs 32bit or 8bit
 	*/
 	is32bit = (src->format->BitsPerPixel == 32);
-	if ((is32bit) || (src->format->BitsPerPixel == 8)) {
+	ispacked = ((src->format->BytesPerPixel == 2) || (src->format->BytesPerPixel == 3)) && (!subpixel);
+	/*
+	* Without a colorkey the areas a rotation leaves uncovered need an
+	* alpha channel; such packed sources are rotated into 32bit RGBA
+	*/
+	packedrgba = (ispacked) && (fabs(angle) > VALUE_LIMIT) && (SDL_GetColorKey(src, &key) != 0);
+	if ((is32bit) || (src->format->BitsPerPixel == 8) || (ispacked)) {
 		/*
 		* Use source surface 'as is' 
 		*/
@@ -1142,19 +3181,32 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		* Alloc space to completely contain the rotated surface 
 		*/
 		rz_dst = NULL;
-		if (is32bit) {
+		if (packedrgba) {
+			/*
+			* Target surface is 32bit with a defined RGBA ordering 
+			*/
+			rz_dst =
+				SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, 32, 
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+				0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#else
+				0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
+#endif
+				);
+		} else if ((is32bit) || (ispacked)) {
 			/*
-			* Target surface is 32bit with source RGBA/ABGR ordering 
+			* Target surface is 32bit with source RGBA/ABGR ordering or
+			* has the packed 16/24bit format of the source
 			*/
 			rz_dst =
-				SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 32,
+				SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, rz_src->format->BitsPerPixel,
 				rz_src->format->Rmask, rz_src->format->Gmask,
 				rz_src->format->Bmask, rz_src->format->Amask);
 		} else {
 			/*
 			* Target surface is 8bit 
 			*/
-			rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 8, 0, 0, 0, 0);
+			rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, 8, 0, 0, 0, 0);
 		}
 
 		/* Check target */
@@ -1174,7 +3226,24 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		/*
 		* Check which kind of surface we have 
 		*/
-		if (is32bit) {
+		if (subpixel) {
+			/*
+			* Copy palette and colorkey info 
+			*/
+			if (!is32bit) {
+				for (i = 0; i < rz_src->format->palette->ncolors; i++) {
+					rz_dst->format->palette->colors[i] = rz_src->format->palette->colors[i];
+				}
+				rz_dst->format->palette->ncolors = rz_src->format->palette->ncolors;
+			}
+			/*
+			* Call the floating point transformation routine to do the rotation
+			*/
+			_rotozoomAffineMatrix(rz_src, rz_dst, 1, 
+				sanglezoom / (zoomx * zoomx), canglezoom / (zoomx * zoomx), 
+				flipx, flipy, matrix);
+			_transformSurfaceWarp(rz_src, rz_dst, matrix, 0, smooth);
+		} else if (is32bit) {
 			/*
 			* Call the 32bit transformation routine to do the rotation (using alpha) 
 			*/
@@ -1182,6 +3251,19 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 				(int) (sanglezoominv), (int) (canglezoominv), 
 				flipx, flipy,
 				smooth);
+		} else if (ispacked) {
+			/*
+			* Call the 16/24bit transformation routine to do the rotation
+			* and copy the colorkey that uncovered areas are set to; an
+			* unkeyed source is rotated into the 32bit RGBA target
+			*/
+			_transformSurfacePacked(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
+				(int) (sanglezoominv), (int) (canglezoominv), 
+				flipx, flipy,
+				smooth);
+			if (SDL_GetColorKey(rz_src, &key) == 0) {
+				SDL_SetColorKey(rz_dst, SDL_TRUE, key);
+			}
 		} else {
 			/*
 			* Copy palette and colorkey info 
@@ -1191,11 +3273,18 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 			}
 			rz_dst->format->palette->ncolors = rz_src->format->palette->ncolors;
 			/*
-			* Call the 8bit transformation routine to do the rotation 
+			* Call the 8bit transformation routine to do the rotation;
+			* grayscale surfaces can be interpolated directly
 			*/
-			transformSurfaceY(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
-				(int) (sanglezoominv), (int) (canglezoominv),
-				flipx, flipy);
+			if ((smooth) && (_isGrayscalePalette(rz_src))) {
+				_transformSurfaceYSmooth(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
+					(int) (sanglezoominv), (int) (canglezoominv),
+					flipx, flipy);
+			} else {
+				transformSurfaceY(rz_src, rz_dst, dstwidthhalf, dstheighthalf,
+					(int) (sanglezoominv), (int) (canglezoominv),
+					flipx, flipy);
+			}
 		}
 		/*
 		* Unlock source surface 
@@ -1222,19 +3311,20 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		* Alloc space to completely contain the zoomed surface 
 		*/
 		rz_dst = NULL;
-		if (is32bit) {
+		if ((is32bit) || (ispacked)) {
 			/*
-			* Target surface is 32bit with source RGBA/ABGR ordering 
+			* Target surface is 32bit with source RGBA/ABGR ordering or
+			* has the packed 16/24bit format of the source
 			*/
 			rz_dst =
-				SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 32,
+				SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, rz_src->format->BitsPerPixel,
 				rz_src->format->Rmask, rz_src->format->Gmask,
 				rz_src->format->Bmask, rz_src->format->Amask);
 		} else {
 			/*
 			* Target surface is 8bit 
 			*/
-			rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 8, 0, 0, 0, 0);
+			rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, 8, 0, 0, 0, 0);
 		}
 
 		/* Check target */
@@ -1254,12 +3344,35 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 		/*
 		* Check which kind of surface we have 
 		*/
-		if (is32bit) {
+		if (subpixel) {
+			/*
+			* Copy palette and colorkey info 
+			*/
+			if (!is32bit) {
+				for (i = 0; i < rz_src->format->palette->ncolors; i++) {
+					rz_dst->format->palette->colors[i] = rz_src->format->palette->colors[i];
+				}
+				rz_dst->format->palette->ncolors = rz_src->format->palette->ncolors;
+			}
+			/*
+			* Call the floating point transformation routine to do the zooming
+			*/
+			_rotozoomAffineMatrix(rz_src, rz_dst, 0, 0.0, 0.0, flipx, flipy, matrix);
+			_transformSurfaceWarp(rz_src, rz_dst, matrix, 0, smooth);
+		} else if (is32bit) {
 			/*
 			* Call the 32bit transformation routine to do the zooming (using alpha) 
 			*/
 			_zoomSurfaceRGBA(rz_src, rz_dst, flipx, flipy, smooth);
 
+		} else if (ispacked) {
+			/*
+			* Call the 16/24bit transformation routine to do the zooming
+			*/
+			_zoomSurfacePacked(rz_src, rz_dst, flipx, flipy, smooth);
+			if (SDL_GetColorKey(rz_src, &key) == 0) {
+				SDL_SetColorKey(rz_dst, SDL_TRUE, key);
+			}
 		} else {
 			/*
 			* Copy palette and colorkey info 
@@ -1270,9 +3383,14 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 			rz_dst->format->palette->ncolors = rz_src->format->palette->ncolors;
 
 			/*
-			* Call the 8bit transformation routine to do the zooming 
+			* Call the 8bit transformation routine to do the zooming;
+			* grayscale surfaces can be interpolated directly
 			*/
-			_zoomSurfaceY(rz_src, rz_dst, flipx, flipy);
+			if ((smooth) && (_isGrayscalePalette(rz_src))) {
+				_zoomSurfaceYSmooth(rz_src, rz_dst, flipx, flipy);
+			} else {
+				_zoomSurfaceY(rz_src, rz_dst, flipx, flipy);
+			}
 		}
 
 		/*
@@ -1296,6 +3414,451 @@ SDL_Surface *rotozoomSurfaceXY(SDL_Surface * src, double angle, double zoomx, do
 	return (rz_dst);
 }
 
+/*!
+\brief Number of hash buckets of a rotozoom cache.
+*/
+#define ROTOZOOM_CACHE_BUCKETS 1024
+
+/*!
+\brief An entry of the rotozoom cache.
+*/
+typedef struct tRotozoomCacheEntry {
+	SDL_Surface *src;	/*!< The source surface (key). */
+	double angle;		/*!< The (quantized) angle (key). */
+	double zoomx;		/*!< The horizontal zoom (key). */
+	double zoomy;		/*!< The vertical zoom (key). */
+	int smooth;		/*!< The smoothing flags (key). */
+	SDL_Surface *dst;	/*!< The cached result. */
+	size_t bytes;		/*!< Size of the pixels of the result. */
+	unsigned int hash;	/*!< Hash of the key. */
+	struct tRotozoomCacheEntry *hnext;	/*!< Next entry in the hash bucket. */
+	struct tRotozoomCacheEntry *prev;	/*!< More recently used entry. */
+	struct tRotozoomCacheEntry *next;	/*!< Less recently used entry. */
+} tRotozoomCacheEntry;
+
+/*!
+\brief State of a rotozoom cache.
+*/
+struct RotozoomCache {
+	size_t maxbytes;	/*!< Memory bound of the cached pixels. */
+	size_t bytes;		/*!< Size of the currently cached pixels. */
+	int anglesteps;		/*!< Number of angle buckets per turn (0 for exact angles). */
+	tRotozoomCacheEntry *head;	/*!< Most recently used entry. */
+	tRotozoomCacheEntry *tail;	/*!< Least recently used entry. */
+	tRotozoomCacheEntry *buckets[ROTOZOOM_CACHE_BUCKETS];	/*!< Hash buckets. */
+};
+
+/*!
+\brief Internal helper which hashes the key of a rotozoom cache entry.
+
+\returns The hash value.
+*/
+static unsigned int _rotozoomCacheHash(SDL_Surface *src, double angle, double zoomx, double zoomy, int smooth)
+{
+	unsigned int h = 2166136261u;
+	unsigned char key[sizeof(SDL_Surface *) + 3 * sizeof(double) + sizeof(int)];
+	size_t i, n;
+
+	/* FNV-1a over the bytes of the key */
+	n = 0;
+	memcpy(key + n, &src, sizeof(SDL_Surface *)); n += sizeof(SDL_Surface *);
+	memcpy(key + n, &angle, sizeof(double)); n += sizeof(double);
+	memcpy(key + n, &zoomx, sizeof(double)); n += sizeof(double);
+	memcpy(key + n, &zoomy, sizeof(double)); n += sizeof(double);
+	memcpy(key + n, &smooth, sizeof(int)); n += sizeof(int);
+	for (i = 0; i < n; i++) {
+		h = (h ^ key[i]) * 16777619u;
+	}
+	return h;
+}
+
+/*!
+\brief Internal helper which removes an entry from a rotozoom cache and frees it.
+
+\param cache The rotozoom cache.
+\param entry The entry to remove.
+*/
+static void _rotozoomCacheRemove(RotozoomCache *cache, tRotozoomCacheEntry *entry)
+{
+	tRotozoomCacheEntry **link;
+
+	/* Unlink from hash bucket */
+	link = &cache->buckets[entry->hash % ROTOZOOM_CACHE_BUCKETS];
+	while (*link != entry) {
+		link = &(*link)->hnext;
+	}
+	*link = entry->hnext;
+
+	/* Unlink from LRU list */
+	if (entry->prev) entry->prev->next = entry->next; else cache->head = entry->next;
+	if (entry->next) entry->next->prev = entry->prev; else cache->tail = entry->prev;
+
+	cache->bytes -= entry->bytes;
+	SDL_FreeSurface(entry->dst);
+	free(entry);
+}
+
+/*! 
+\brief Create a cache for repeated rotozooms of the same surfaces.
+
+The cache memoizes the results of rotozoomSurfaceXY() keyed by source surface,
+angle, zoom factors and smoothing flags. Angles can be quantized into buckets so
+that continuously changing angles map onto a small set of cached results.
+The least recently used results are dropped when the cached pixels would exceed
+the memory bound.
+
+\param maxbytes The maximum number of bytes of cached pixel data.
+\param anglesteps The number of angle buckets per 360 degrees (e.g. 360 for 1 degree steps) or 0 to use exact angles.
+
+\return The new cache or NULL on error.
+*/
+/*@null@*/ 
+RotozoomCache *rotozoomCacheCreate(size_t maxbytes, int anglesteps)
+{
+	RotozoomCache *cache;
+
+	if (anglesteps < 0) {
+		SDL_SetError("Invalid number of angle steps");
+		return (NULL);
+	}
+	cache = (RotozoomCache *) calloc(1, sizeof(RotozoomCache));
+	if (cache == NULL) {
+		SDL_SetError("Out of memory");
+		return (NULL);
+	}
+	cache->maxbytes = maxbytes;
+	cache->anglesteps = anglesteps;
+	return (cache);
+}
+
+/*! 
+\brief Rotozoom a surface through a rotozoom cache.
+
+Returns the cached result if the same source was transformed with the same 
+(quantized) angle, zoom factors and smoothing before; otherwise calls 
+rotozoomSurfaceXY() and caches the result. The returned surface is shared 
+with the cache and must not be modified; it holds its own reference and has 
+to be released with SDL_FreeSurface() by the caller. 
+Call rotozoomCacheInvalidate() whenever the pixels of a source surface change
+and before a source surface is freed.
+
+\param cache The rotozoom cache.
+\param src The surface to rotozoom.
+\param angle The angle to rotate in degrees; quantized to the angle steps of the cache.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flags as for rotozoomSurfaceXY().
+
+\return The rotozoomed surface or NULL on error.
+*/
+/*@null@*/ 
+SDL_Surface *rotozoomCacheGet(RotozoomCache *cache, SDL_Surface *src, double angle, double zoomx, double zoomy, int smooth)
+{
+	tRotozoomCacheEntry *entry;
+	SDL_Surface *dst;
+	unsigned int hash;
+	double step;
+
+	/*
+	* Sanity check 
+	*/
+	if ((cache == NULL) || (src == NULL)) {
+		SDL_SetError("NULL cache or source surface");
+		return (NULL);
+	}
+
+	/*
+	* Quantize angle into [0,360) buckets
+	*/
+	if (cache->anglesteps > 0) {
+		step = 360.0 / (double)cache->anglesteps;
+		angle = floor(angle / step + 0.5);
+		angle = fmod(angle, (double)cache->anglesteps);
+		if (angle < 0.0) {
+			angle += (double)cache->anglesteps;
+		}
+		angle *= step;
+	}
+	if (angle == 0.0) {
+		/* Same key for -0.0 */
+		angle = 0.0;
+	}
+
+	/*
+	* Look up and move to the front of the LRU list
+	*/
+	hash = _rotozoomCacheHash(src, angle, zoomx, zoomy, smooth);
+	for (entry = cache->buckets[hash % ROTOZOOM_CACHE_BUCKETS]; entry != NULL; entry = entry->hnext) {
+		if ((entry->src == src) && (entry->angle == angle) && (entry->zoomx == zoomx) &&
+			(entry->zoomy == zoomy) && (entry->smooth == smooth)) {
+			if (entry != cache->head) {
+				entry->prev->next = entry->next;
+				if (entry->next) entry->next->prev = entry->prev; else cache->tail = entry->prev;
+				entry->prev = NULL;
+				entry->next = cache->head;
+				cache->head->prev = entry;
+				cache->head = entry;
+			}
+			entry->dst->refcount++;
+			return (entry->dst);
+		}
+	}
+
+	/*
+	* Miss: transform and keep the result if it fits
+	*/
+	dst = rotozoomSurfaceXY(src, angle, zoomx, zoomy, smooth);
+	if (dst == NULL) {
+		return (NULL);
+	}
+	entry = (tRotozoomCacheEntry *) malloc(sizeof(tRotozoomCacheEntry));
+	if (entry == NULL) {
+		return (dst);
+	}
+	entry->bytes = (size_t)dst->pitch * dst->h;
+	if (entry->bytes > cache->maxbytes) {
+		free(entry);
+		return (dst);
+	}
+	while ((cache->tail != NULL) && (cache->bytes + entry->bytes > cache->maxbytes)) {
+		_rotozoomCacheRemove(cache, cache->tail);
+	}
+	entry->src = src;
+	entry->angle = angle;
+	entry->zoomx = zoomx;
+	entry->zoomy = zoomy;
+	entry->smooth = smooth;
+	entry->dst = dst;
+	entry->hash = hash;
+	entry->hnext = cache->buckets[hash % ROTOZOOM_CACHE_BUCKETS];
+	cache->buckets[hash % ROTOZOOM_CACHE_BUCKETS] = entry;
+	entry->prev = NULL;
+	entry->next = cache->head;
+	if (cache->head) cache->head->prev = entry; else cache->tail = entry;
+	cache->head = entry;
+	cache->bytes += entry->bytes;
+
+	/* One reference for the cache, one for the caller */
+	dst->refcount++;
+	return (dst);
+}
+
+/*! 
+\brief Drop cached results of a rotozoom cache.
+
+\param cache The rotozoom cache.
+\param src The source surface whose results are dropped or NULL to drop all results.
+*/
+void rotozoomCacheInvalidate(RotozoomCache *cache, SDL_Surface *src)
+{
+	tRotozoomCacheEntry *entry, *next;
+
+	if (cache == NULL) {
+		return;
+	}
+	for (entry = cache->head; entry != NULL; entry = next) {
+		next = entry->next;
+		if ((src == NULL) || (entry->src == src)) {
+			_rotozoomCacheRemove(cache, entry);
+		}
+	}
+}
+
+/*! 
+\brief Free a rotozoom cache and its cached results.
+
+Surfaces returned by rotozoomCacheGet() which were not yet released by the caller remain valid.
+
+\param cache The rotozoom cache to free; may be NULL.
+*/
+void rotozoomCacheFree(RotozoomCache *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+	rotozoomCacheInvalidate(cache, NULL);
+	free(cache);
+}
+
+/*! 
+\brief Rotozoom a surface directly into a locked streaming texture.
+
+Rotates and zooms a 32bit or packed 16/24bit 'src' surface like rotozoomSurfaceXY()
+but writes the result into the pixels returned by SDL_LockTexture() for the upper left 
+area of 'texture', respecting the pitch of the lock. No intermediate surface is 
+allocated. The texture must be created with SDL_TEXTUREACCESS_STREAMING and the pixel 
+format of the source surface and must be at least as large as the result (see 
+rotozoomSurfaceSizeXY()). Pixels not covered by the rotated source are set to 
+transparent black (32bit) or the source colorkey (16/24bit), so the texture holds 
+the same pixels as the surface returned by rotozoomSurfaceXY(). Packed 16/24bit 
+surfaces can only be rotated if they have a colorkey, since rotozoomSurfaceXY() 
+returns unkeyed rotations as 32bit RGBA. SMOOTHING_SUBPIXEL is only used for 
+32bit surfaces.
+
+\param src The surface to rotozoom.
+\param angle The angle to rotate in degrees.
+\param zoomx The horizontal scaling factor.
+\param zoomy The vertical scaling factor.
+\param smooth Antialiasing flags as for rotozoomSurfaceXY().
+\param texture The streaming texture receiving the result.
+\param dstrect Pointer to a rectangle receiving the area of the texture holding the result (to be used as source rectangle when rendering); may be NULL.
+
+\return 0 for success or -1 for error.
+*/
+int rotozoomSurfaceXYToTexture(SDL_Surface * src, double angle, double zoomx, double zoomy, int smooth, 
+	SDL_Texture * texture, SDL_Rect * dstrect)
+{
+	SDL_Surface rz_dst;
+	SDL_Rect rect;
+	Uint32 format;
+	void *pixels;
+	double zoominv, sanglezoom, canglezoom, matrix[6];
+	int access, texw, texh, pitch, dstwidth, dstheight, y;
+	int is32bit, ispacked, rotate, flipx, flipy, subpixel;
+	Uint32 key;
+
+	/*
+	* Sanity check 
+	*/
+	if ((src == NULL) || (texture == NULL)) {
+		SDL_SetError("NULL source surface or texture");
+		return (-1);
+	}
+	smooth = _smoothingFlags(smooth, &subpixel);
+	is32bit = (src->format->BitsPerPixel == 32);
+	ispacked = ((src->format->BytesPerPixel == 2) || (src->format->BytesPerPixel == 3));
+	if (ispacked) {
+		/* The floating point transformer needs 32bit */
+		subpixel = 0;
+	}
+	if ((!is32bit) && (!ispacked)) {
+		SDL_SetError("Unsupported source surface format");
+		return (-1);
+	}
+	if (SDL_QueryTexture(texture, &format, &access, &texw, &texh) < 0) {
+		return (-1);
+	}
+	if (access != SDL_TEXTUREACCESS_STREAMING) {
+		SDL_SetError("Texture is not a streaming texture");
+		return (-1);
+	}
+	if (format != src->format->format) {
+		SDL_SetError("Texture format does not match source surface");
+		return (-1);
+	}
+
+	/*
+	* Sanity check zoom factor 
+	*/
+	flipx = (zoomx<0.0);
+	if (flipx) zoomx=-zoomx;
+	flipy = (zoomy<0.0);
+	if (flipy) zoomy=-zoomy;
+	if (zoomx < VALUE_LIMIT) zoomx = VALUE_LIMIT;
+	if (zoomy < VALUE_LIMIT) zoomy = VALUE_LIMIT;
+	zoominv = 65536.0 / (zoomx * zoomx);
+
+	/*
+	* Determine target size; rotozoomSurfaceXY() returns rotations of
+	* packed surfaces without colorkey as 32bit RGBA, which the texture
+	* in the source format cannot hold
+	*/
+	rotate = (fabs(angle) > VALUE_LIMIT);
+	if ((rotate) && (ispacked) && (SDL_GetColorKey(src, &key) != 0)) {
+		SDL_SetError("Rotation of a 16/24bit surface requires a colorkey");
+		return (-1);
+	}
+	if (rotate) {
+		_rotozoomSurfaceSizeTrig(src->w, src->h, angle, zoomx, zoomy, &dstwidth, &dstheight, &canglezoom, &sanglezoom);
+	} else {
+		zoomSurfaceSize(src->w, src->h, zoomx, zoomy, &dstwidth, &dstheight);
+		sanglezoom = canglezoom = 0.0;
+	}
+	if ((dstwidth > texw) || (dstheight > texh)) {
+		SDL_SetError("Texture too small for rotozoomed surface");
+		return (-1);
+	}
+
+	/*
+	* Lock the target area and wrap it into a surface header
+	*/
+	rect.x = 0;
+	rect.y = 0;
+	rect.w = dstwidth;
+	rect.h = dstheight;
+	if (SDL_LockTexture(texture, &rect, &pixels, &pitch) < 0) {
+		return (-1);
+	}
+	memset(&rz_dst, 0, sizeof(SDL_Surface));
+	rz_dst.format = src->format;
+	rz_dst.w = dstwidth;
+	rz_dst.h = dstheight;
+	rz_dst.pitch = pitch;
+	rz_dst.pixels = pixels;
+	rz_dst.refcount = 1;
+
+	/*
+	* Lock source surface 
+	*/
+	if (SDL_MUSTLOCK(src)) {
+		SDL_LockSurface(src);
+	}
+
+	if ((rotate) && (is32bit)) {
+		/*
+		* The transformers only write covered pixels; clear the previous content
+		*/
+		for (y = 0; y < dstheight; y++) {
+			memset((Uint8 *)pixels + y * pitch, 0, dstwidth * 4);
+		}
+	}
+	if (subpixel) {
+		/*
+		* Call the floating point transformation routine
+		*/
+		_rotozoomAffineMatrix(src, &rz_dst, rotate, 
+			sanglezoom / (zoomx * zoomx), canglezoom / (zoomx * zoomx), 
+			flipx, flipy, matrix);
+		_transformSurfaceWarp(src, &rz_dst, matrix, 0, smooth);
+	} else if (rotate) {
+		/*
+		* Call the 32bit or 16/24bit transformation routine to do the rotation 
+		*/
+		if (is32bit) {
+			_transformSurfaceRGBA(src, &rz_dst, dstwidth / 2, dstheight / 2,
+				(int) (sanglezoom * zoominv), (int) (canglezoom * zoominv), 
+				flipx, flipy, smooth);
+		} else {
+			_transformSurfacePacked(src, &rz_dst, dstwidth / 2, dstheight / 2,
+				(int) (sanglezoom * zoominv), (int) (canglezoom * zoominv), 
+				flipx, flipy, smooth);
+		}
+	} else {
+		/*
+		* Call the 32bit or 16/24bit transformation routine to do the zooming 
+		*/
+		if (is32bit) {
+			_zoomSurfaceRGBA(src, &rz_dst, flipx, flipy, smooth);
+		} else {
+			_zoomSurfacePacked(src, &rz_dst, flipx, flipy, smooth);
+		}
+	}
+
+	/*
+	* Unlock source surface and texture
+	*/
+	if (SDL_MUSTLOCK(src)) {
+		SDL_UnlockSurface(src);
+	}
+	SDL_UnlockTexture(texture);
+
+	if (dstrect != NULL) {
+		*dstrect = rect;
+	}
+
+	return (0);
+}
+
 /*!
 \brief Calculates the size of the target surface for a zoomSurface() call.
 
@@ -1347,14 +3910,17 @@ void zoomSurfaceSize(int width, int height, double zoomx, double zoomy, int *dst
 
 Zooms a 32bit or 8bit 'src' surface to newly created 'dst' surface.
 'zoomx' and 'zoomy' are scaling factors for width and height. If 'smooth' is on
-then the destination 32bit surface is anti-aliased. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+then the destination 32bit surface or 8bit surface with a grayscale palette is
+anti-aliased. 32bit, 8bit, packed 16bit (e.g. RGB565) and 24bit surfaces are
+returned in the source format, except that packed surfaces with SMOOTHING_SUBPIXEL
+and all other formats are returned as a 32bit RGBA surface. Note: earlier versions
+returned packed 16bit and 24bit surfaces as 32bit RGBA surfaces.
 If zoom factors are negative, the image is flipped on the axes.
 
 \param src The surface to zoom.
 \param zoomx The horizontal zoom factor.
 \param zoomy The vertical zoom factor.
-\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. Add SMOOTHING_SUBPIXEL to use the floating point transformer. Add SMOOTHING_PREMULTIPLIED or SMOOTHING_PREMULTIPLIED_OUTPUT for alpha weighted smoothing of 32 bit surfaces.
 
 \return The new, zoomed surface.
 */
@@ -1363,9 +3929,12 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 	SDL_Surface *rz_src;
 	SDL_Surface *rz_dst;
 	int dstwidth, dstheight;
-	int is32bit;
+	int is32bit, ispacked;
 	int i, src_converted;
 	int flipx, flipy;
+	int subpixel, guardrows;
+	Uint32 key;
+	double matrix[6];
 
 	/*
 	* Sanity check 
@@ -1374,10 +3943,19 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 		return (NULL);
 
 	/*
-	* Determine if source surface is 32bit or 8bit 
+	* Split off transformer selection from smoothing flag; the floating
+	* point transformer does not need guard rows
+	*/
+	smooth = _smoothingFlags(smooth, &subpixel);
+	guardrows = (subpixel) ? 0 : GUARD_ROWS;
+
+	/*
+	* Determine if source surface is 32bit, 8bit or packed 16/24bit;
+	* the floating point transformer needs 32bit or 8bit
 	*/
 	is32bit = (src->format->BitsPerPixel == 32);
-	if ((is32bit) || (src->format->BitsPerPixel == 8)) {
+	ispacked = ((src->format->BytesPerPixel == 2) || (src->format->BytesPerPixel == 3)) && (!subpixel);
+	if ((is32bit) || (src->format->BitsPerPixel == 8) || (ispacked)) {
 		/*
 		* Use source surface 'as is' 
 		*/
@@ -1415,19 +3993,20 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 	* Alloc space to completely contain the zoomed surface 
 	*/
 	rz_dst = NULL;
-	if (is32bit) {
+	if ((is32bit) || (ispacked)) {
 		/*
-		* Target surface is 32bit with source RGBA/ABGR ordering 
+		* Target surface is 32bit with source RGBA/ABGR ordering or
+		* has the packed 16/24bit format of the source
 		*/
 		rz_dst =
-			SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 32,
+			SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, rz_src->format->BitsPerPixel,
 			rz_src->format->Rmask, rz_src->format->Gmask,
 			rz_src->format->Bmask, rz_src->format->Amask);
 	} else {
 		/*
 		* Target surface is 8bit 
 		*/
-		rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 8, 0, 0, 0, 0);
+		rz_dst = SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + guardrows, 8, 0, 0, 0, 0);
 	}
 
 	/* Check target */
@@ -1454,11 +4033,34 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 	/*
 	* Check which kind of surface we have 
 	*/
-	if (is32bit) {
+	if (subpixel) {
+		/*
+		* Copy palette and colorkey info 
+		*/
+		if (!is32bit) {
+			for (i = 0; i < rz_src->format->palette->ncolors; i++) {
+				rz_dst->format->palette->colors[i] = rz_src->format->palette->colors[i];
+			}
+			rz_dst->format->palette->ncolors = rz_src->format->palette->ncolors;
+		}
+		/*
+		* Call the floating point transformation routine to do the zooming
+		*/
+		_rotozoomAffineMatrix(rz_src, rz_dst, 0, 0.0, 0.0, flipx, flipy, matrix);
+		_transformSurfaceWarp(rz_src, rz_dst, matrix, 0, smooth);
+	} else if (is32bit) {
 		/*
 		* Call the 32bit transformation routine to do the zooming (using alpha) 
 		*/
 		_zoomSurfaceRGBA(rz_src, rz_dst, flipx, flipy, smooth);
+	} else if (ispacked) {
+		/*
+		* Call the 16/24bit transformation routine to do the zooming
+		*/
+		_zoomSurfacePacked(rz_src, rz_dst, flipx, flipy, smooth);
+		if (SDL_GetColorKey(rz_src, &key) == 0) {
+			SDL_SetColorKey(rz_dst, SDL_TRUE, key);
+		}
 	} else {
 		/*
 		* Copy palette and colorkey info 
@@ -1468,9 +4070,14 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 		}
 		rz_dst->format->palette->ncolors = rz_src->format->palette->ncolors;
 		/*
-		* Call the 8bit transformation routine to do the zooming 
+		* Call the 8bit transformation routine to do the zooming;
+		* grayscale surfaces can be interpolated directly
 		*/
-		_zoomSurfaceY(rz_src, rz_dst, flipx, flipy);
+		if ((smooth) && (_isGrayscalePalette(rz_src))) {
+			_zoomSurfaceYSmooth(rz_src, rz_dst, flipx, flipy);
+		} else {
+			_zoomSurfaceY(rz_src, rz_dst, flipx, flipy);
+		}
 	}
 	/*
 	* Unlock source surface 
@@ -1492,14 +4099,226 @@ SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smoo
 	return (rz_dst);
 }
 
+/*!
+\brief State of a streaming zoom.
+*/
+struct ZoomStream {
+	int srcwidth;		/*!< Width of the source rows. */
+	int srcheight;		/*!< Total number of source rows. */
+	int dstwidth;		/*!< Width of the destination rows. */
+	int dstheight;		/*!< Total number of destination rows. */
+	int smooth;		/*!< Smoothing flags. */
+	int *sax;		/*!< Horizontal 16.16 source positions. */
+	int *say;		/*!< Vertical 16.16 source positions. */
+	tColorRGBA *rows[2];	/*!< The last two source rows (indexed by row parity). */
+	tColorRGBA *dstrow;	/*!< The destination row handed to the callback. */
+	int nextsrc;		/*!< Index of the next source row to be pushed. */
+	int nextdst;		/*!< Index of the next destination row to be emitted. */
+	ZoomStreamRowCallback callback;	/*!< Callback receiving destination rows. */
+	void *userdata;		/*!< User data passed to the callback. */
+};
+
+/*! 
+\brief Create a streaming zoom of a 32 bit image too large to be held in memory.
+
+The source rows are pushed in bands with zoomStreamPushRows(); each destination
+row is produced as soon as the source rows it depends on are available and handed 
+to the callback. Only the last two source rows and one destination row are kept,
+so neither the source nor the destination image need to be in memory.
+The result is identical to zoomSurface() of the complete 32 bit RGBA/ABGR source 
+(without flipping); channels are processed in the order of the source pixels.
+
+\param srcwidth The width of the source image.
+\param srcheight The height of the source image.
+\param dstwidth The width of the destination image.
+\param dstheight The height of the destination image.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. SMOOTHING_PREMULTIPLIED 
+and SMOOTHING_PREMULTIPLIED_OUTPUT select alpha weighted interpolation.
+\param callback The function receiving the destination rows.
+\param userdata User data passed to the callback.
+
+\return The new stream or NULL on error.
+*/
+/*@null@*/ 
+ZoomStream *zoomStreamCreate(int srcwidth, int srcheight, int dstwidth, int dstheight, int smooth,
+	ZoomStreamRowCallback callback, void *userdata)
+{
+	ZoomStream *stream;
+	int subpixel;
+
+	/*
+	* Sanity check 
+	*/
+	if ((srcwidth < 1) || (srcheight < 1) || (dstwidth < 1) || (dstheight < 1) || (callback == NULL)) {
+		SDL_SetError("Invalid zoom stream size or callback");
+		return (NULL);
+	}
+
+	stream = (ZoomStream *) calloc(1, sizeof(ZoomStream));
+	if (stream == NULL) {
+		SDL_SetError("Out of memory");
+		return (NULL);
+	}
+	stream->srcwidth = srcwidth;
+	stream->srcheight = srcheight;
+	stream->dstwidth = dstwidth;
+	stream->dstheight = dstheight;
+	stream->smooth = _smoothingFlags(smooth, &subpixel);
+	stream->callback = callback;
+	stream->userdata = userdata;
+	stream->sax = (int *) malloc((dstwidth + 1) * sizeof(int));
+	stream->say = (int *) malloc((dstheight + 1) * sizeof(int));
+	stream->rows[0] = (tColorRGBA *) malloc(srcwidth * sizeof(tColorRGBA));
+	stream->rows[1] = (tColorRGBA *) malloc(srcwidth * sizeof(tColorRGBA));
+	stream->dstrow = (tColorRGBA *) malloc(dstwidth * sizeof(tColorRGBA));
+	if ((stream->sax == NULL) || (stream->say == NULL) || (stream->rows[0] == NULL) || 
+		(stream->rows[1] == NULL) || (stream->dstrow == NULL)) {
+		zoomStreamFree(stream);
+		SDL_SetError("Out of memory");
+		return (NULL);
+	}
+
+	/*
+	* Precalculate source positions like _zoomSurfaceRGBA()
+	*/
+	_zoomSampleTable(srcwidth, dstwidth, stream->smooth, stream->sax);
+	_zoomSampleTable(srcheight, dstheight, stream->smooth, stream->say);
+
+	return (stream);
+}
+
+/*!
+\brief Internal helper which emits all destination rows of a zoom stream that are ready.
+
+\param stream The zoom stream.
+\param lastrow Index of the last source row pushed.
+*/
+static void _zoomStreamEmit(ZoomStream *stream, int lastrow)
+{
+	int x, cx, cy, cy1, ex, ey, t1, t2, spixelw, premultiplied, premultipliedout;
+	tColorRGBA *row0, *row1, *c00, *c01, *c10, *c11, *dp;
+
+	spixelw = stream->srcwidth - 1;
+	premultiplied = (stream->smooth & SMOOTHING_PREMULTIPLIED_MASK);
+	premultipliedout = (stream->smooth & SMOOTHING_PREMULTIPLIED_OUTPUT);
+	while (stream->nextdst < stream->dstheight) {
+		cy = stream->say[stream->nextdst] >> 16;
+		ey = stream->say[stream->nextdst] & 0xffff;
+		cy1 = ((stream->smooth) && (cy < stream->srcheight - 1)) ? cy + 1 : cy;
+		if (cy1 > lastrow) {
+			/* Wait for more source rows */
+			return;
+		}
+		row0 = stream->rows[cy & 1];
+		row1 = stream->rows[cy1 & 1];
+		dp = stream->dstrow;
+		if (stream->smooth) {
+			for (x = 0; x < stream->dstwidth; x++) {
+				cx = stream->sax[x] >> 16;
+				ex = stream->sax[x] & 0xffff;
+				c00 = row0 + cx;
+				c10 = row1 + cx;
+				c01 = (cx < spixelw) ? c00 + 1 : c00;
+				c11 = (cx < spixelw) ? c10 + 1 : c10;
+				if (premultiplied) {
+					_interpolatePremultiplied(*c00, *c01, *c10, *c11, ex, ey, premultipliedout, dp);
+				} else {
+					t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
+					t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
+					dp->r = (((t2 - t1) * ey) >> 16) + t1;
+					t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
+					t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
+					dp->g = (((t2 - t1) * ey) >> 16) + t1;
+					t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
+					t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
+					dp->b = (((t2 - t1) * ey) >> 16) + t1;
+					t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
+					t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
+					dp->a = (((t2 - t1) * ey) >> 16) + t1;
+				}
+				dp++;
+			}
+		} else {
+			for (x = 0; x < stream->dstwidth; x++) {
+				*dp = row0[stream->sax[x] >> 16];
+				dp++;
+			}
+		}
+		stream->callback(stream->userdata, stream->nextdst, stream->dstrow, stream->dstwidth);
+		stream->nextdst++;
+	}
+}
+
+/*! 
+\brief Push a band of source rows into a streaming zoom.
+
+Rows must be pushed top to bottom; the band may contain any number of rows.
+Destination rows which become available are passed to the callback before
+this function returns.
+
+\param stream The zoom stream.
+\param pixels Pointer to the first 32 bit pixel of the band.
+\param pitch The number of bytes between rows of the band.
+\param numrows The number of rows in the band.
+
+\return 0 for success or -1 for error.
+*/
+int zoomStreamPushRows(ZoomStream *stream, const void *pixels, int pitch, int numrows)
+{
+	int i;
+
+	/*
+	* Sanity check 
+	*/
+	if ((stream == NULL) || (pixels == NULL) || (numrows < 0)) {
+		SDL_SetError("NULL zoom stream or pixels");
+		return (-1);
+	}
+	if (stream->nextsrc + numrows > stream->srcheight) {
+		SDL_SetError("Too many source rows pushed into zoom stream");
+		return (-1);
+	}
+
+	for (i = 0; i < numrows; i++) {
+		/*
+		* Keep the row and produce what depends on it
+		*/
+		memcpy(stream->rows[stream->nextsrc & 1], (const Uint8 *)pixels + i * pitch, stream->srcwidth * sizeof(tColorRGBA));
+		_zoomStreamEmit(stream, stream->nextsrc);
+		stream->nextsrc++;
+	}
+
+	return (0);
+}
+
+/*! 
+\brief Free a streaming zoom.
+
+\param stream The zoom stream to free; may be NULL.
+*/
+void zoomStreamFree(ZoomStream *stream)
+{
+	if (stream == NULL) {
+		return;
+	}
+	free(stream->sax);
+	free(stream->say);
+	free(stream->rows[0]);
+	free(stream->rows[1]);
+	free(stream->dstrow);
+	free(stream);
+}
+
 /*! 
 \brief Shrink a surface by an integer ratio using averaging.
 
 Shrinks a 32bit or 8bit 'src' surface to a newly created 'dst' surface.
 'factorx' and 'factory' are the shrinking ratios (i.e. 2=1/2 the size,
 3=1/3 the size, etc.) The destination surface is antialiased by averaging
-the source box RGBA or Y information. If the surface is not 8bit
-or 32bit RGBA/ABGR it will be converted into a 32bit RGBA format on the fly.
+the source box RGBA or Y information. 32bit, 8bit, packed 16bit (e.g. RGB565)
+and 24bit surfaces are returned in the source format; all other formats are
+returned as a 32bit RGBA surface. Note: earlier versions returned packed 16bit 
+and 24bit surfaces as 32bit RGBA surfaces.
 The input surface is not modified. The output surface is newly allocated.
 
 \param src The surface to shrink.
@@ -1515,8 +4334,9 @@ SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 	SDL_Surface *rz_src;
 	SDL_Surface *rz_dst = NULL;
 	int dstwidth, dstheight;
-	int is32bit;
+	int is32bit, ispacked;
 	int i, src_converted;
+	Uint32 key;
 	int haveError = 0;
 
 	/*
@@ -1527,10 +4347,11 @@ SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 	}
 
 	/*
-	* Determine if source surface is 32bit or 8bit 
+	* Determine if source surface is 32bit, 8bit or packed 16/24bit
 	*/
 	is32bit = (src->format->BitsPerPixel == 32);
-	if ((is32bit) || (src->format->BitsPerPixel == 8)) {
+	ispacked = ((src->format->BytesPerPixel == 2) || (src->format->BytesPerPixel == 3));
+	if ((is32bit) || (src->format->BitsPerPixel == 8) || (ispacked)) {
 		/*
 		* Use source surface 'as is' 
 		*/
@@ -1577,12 +4398,13 @@ SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 	* Alloc space to completely contain the shrunken surface
 	* (with added guard rows)
 	*/
-	if (is32bit==1) {
+	if ((is32bit==1) || (ispacked)) {
 		/*
-		* Target surface is 32bit with source RGBA/ABGR ordering 
+		* Target surface is 32bit with source RGBA/ABGR ordering or
+		* has the packed 16/24bit format of the source
 		*/
 		rz_dst =
-			SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, 32,
+			SDL_CreateRGBSurface(SDL_SWSURFACE, dstwidth, dstheight + GUARD_ROWS, rz_src->format->BitsPerPixel,
 			rz_src->format->Rmask, rz_src->format->Gmask,
 			rz_src->format->Bmask, rz_src->format->Amask);
 	} else {
@@ -1613,6 +4435,18 @@ SDL_Surface *shrinkSurface(SDL_Surface *src, int factorx, int factory)
 			haveError = 1;
 			goto exitShrinkSurface;
 		}
+	} else if (ispacked) {
+		/*
+		* Call the 16/24bit transformation routine to do the shrinking 
+		*/
+		result = _shrinkSurfacePacked(rz_src, rz_dst, factorx, factory);
+		if (result!=0) {
+			haveError = 1;
+			goto exitShrinkSurface;
+		}
+		if (SDL_GetColorKey(rz_src, &key) == 0) {
+			SDL_SetColorKey(rz_dst, SDL_TRUE, key);
+		}
 	} else {
 		/*
 		* Copy palette and colorkey info 
@@ -1661,3 +4495,411 @@ exitShrinkSurface:
 	*/
 	return (rz_dst);
 }
+
+/*!
+\brief Internal helper which averages one row of the next mipmap level.
+
+Each destination byte is the average of a 2x2 box of source bytes (RGBA channels
+or Y values); a factor of 1 in either direction repeats the source sample.
+Averaging truncates the same way as _shrinkSurfaceRGBA and _shrinkSurfaceY.
+
+\param s0 Pointer to the upper source row.
+\param s1 Pointer to the lower source row (may equal s0).
+\param d Pointer to the destination row.
+\param dw The width of the destination row in pixels.
+\param bpp The number of bytes per pixel (4 or 1).
+\param factorx The horizontal reduction factor (1 or 2).
+*/
+static void _mipChainRow(const Uint8 *s0, const Uint8 *s1, Uint8 *d, int dw, int bpp, int factorx)
+{
+	int x, c, step, next;
+
+	if ((bpp == 4) && (factorx == 2) && (s0 != s1)) {
+		_shrinkRowRGBA2x2(s0, s1, d, dw);
+		return;
+	}
+	step = bpp * factorx;
+	next = (factorx == 2) ? bpp : 0;
+	for (x = 0; x < dw; x++) {
+		for (c = 0; c < bpp; c++) {
+			d[c] = (Uint8)((s0[c] + s0[c + next] + s1[c] + s1[c + next]) >> 2);
+		}
+		d += bpp;
+		s0 += step;
+		s1 += step;
+	}
+}
+
+/*! 
+\brief Build a complete mipmap pyramid of a surface.
+
+Creates the chain of 'src' and all successive 1/2 size levels down to 1x1 pixels.
+Each level is obtained from the previous one by averaging 2x2 pixel boxes like
+shrinkSurface() does; a dimension which has reached 1 pixel is kept at 1.
+The pyramid is generated in a single pass over the source: whenever a level has
+produced two new rows the next row of the following level is computed, so all
+levels are built while their input rows are still in the cache.
+All levels share one contiguous allocation. The levels of 32bit and 8bit surfaces
+have the source format; for all other formats, including packed 16bit and 24bit
+surfaces, every level (also level 0) is a 32bit RGBA surface.
+The input surface is not modified. The chain must be released with freeMipChain().
+
+\param src The surface to build the pyramid from.
+\param numLevels Pointer receiving the number of levels (including the full size level 0); may be NULL.
+
+\return NULL terminated array of the level surfaces or NULL on error.
+*/
+/*@null@*/ 
+SDL_Surface **buildMipChain(SDL_Surface *src, int *numLevels)
+{
+	SDL_Surface *rz_src;
+	SDL_Surface **chain = NULL;
+	Uint8 *pixels;
+	size_t offset, size;
+	int levels, level, bpp, w, h, y, row, factory, i, src_converted;
+	int haveError = 0;
+
+	/*
+	* Sanity check 
+	*/
+	if (src == NULL) {
+		return (NULL);
+	}
+
+	/*
+	* Determine if source surface is 32bit or 8bit 
+	*/
+	if ((src->format->BitsPerPixel == 32) || (src->format->BitsPerPixel == 8)) {
+		/*
+		* Use source surface 'as is' 
+		*/
+		rz_src = src;
+		src_converted = 0;
+	} else {
+		/*
+		* New source surface is 32bit with a defined RGBA ordering 
+		*/
+		rz_src = SDL_CreateRGBSurface(SDL_SWSURFACE, src->w, src->h, 32, 
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+			0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#else
+			0xff000000,  0x00ff0000, 0x0000ff00, 0x000000ff
+#endif
+			);
+		if (rz_src == NULL) {
+			return (NULL);
+		}
+		SDL_BlitSurface(src, NULL, rz_src, NULL);
+		src_converted = 1;
+	}
+	bpp = rz_src->format->BytesPerPixel;
+
+	/*
+	* Count levels and the size of the pixel data; every level
+	* starts 16 byte aligned
+	*/
+	levels = 1;
+	size = 0;
+	w = rz_src->w;
+	h = rz_src->h;
+	while (1) {
+		size += (((size_t)((w * bpp + 3) & ~3) * h) + 15) & ~(size_t)15;
+		if ((w == 1) && (h == 1)) {
+			break;
+		}
+		w = MAX(w / 2, 1);
+		h = MAX(h / 2, 1);
+		levels++;
+	}
+
+	/*
+	* One allocation holds the surface pointers followed by the pixels of all levels
+	*/
+	offset = ((levels + 1) * sizeof(SDL_Surface *) + 15) & ~(size_t)15;
+	chain = (SDL_Surface **) malloc(offset + size + 15);
+	if (chain == NULL) {
+		SDL_SetError("Out of memory");
+		haveError = 1;
+		goto exitBuildMipChain;
+	}
+	pixels = (Uint8 *)(((size_t)chain + offset + 15) & ~(size_t)15);
+	for (level = 0; level <= levels; level++) {
+		chain[level] = NULL;
+	}
+
+	/*
+	* Create the level surfaces on top of the pixel block
+	*/
+	w = rz_src->w;
+	h = rz_src->h;
+	for (level = 0; level < levels; level++) {
+		chain[level] = SDL_CreateRGBSurfaceFrom(pixels, w, h, bpp * 8, (w * bpp + 3) & ~3,
+			rz_src->format->Rmask, rz_src->format->Gmask,
+			rz_src->format->Bmask, rz_src->format->Amask);
+		if (chain[level] == NULL) {
+			haveError = 1;
+			goto exitBuildMipChain;
+		}
+		if (bpp == 1) {
+			/*
+			* Copy palette info 
+			*/
+			for (i = 0; i < rz_src->format->palette->ncolors; i++) {
+				chain[level]->format->palette->colors[i] = rz_src->format->palette->colors[i];
+			}
+			chain[level]->format->palette->ncolors = rz_src->format->palette->ncolors;
+		}
+		pixels += ((((size_t)chain[level]->pitch * h) + 15) & ~(size_t)15);
+		w = MAX(w / 2, 1);
+		h = MAX(h / 2, 1);
+	}
+
+	/*
+	* Lock the surface 
+	*/
+	if (SDL_MUSTLOCK(rz_src)) {
+		if (SDL_LockSurface(rz_src) < 0) {
+			haveError = 1;
+			goto exitBuildMipChain;
+		}
+	}
+
+	/*
+	* Stream the source rows into level 0 and cascade completed row
+	* pairs down the pyramid
+	*/
+	for (y = 0; y < rz_src->h; y++) {
+		memcpy((Uint8 *)chain[0]->pixels + y * chain[0]->pitch,
+			(Uint8 *)rz_src->pixels + y * rz_src->pitch, rz_src->w * bpp);
+		row = y;
+		for (level = 1; level < levels; level++) {
+			factory = (chain[level - 1]->h > 1) ? 2 : 1;
+			if (((row + 1) % factory) != 0) {
+				break;
+			}
+			row = row / factory;
+			if (row >= chain[level]->h) {
+				/* Odd trailing row is dropped */
+				break;
+			}
+			_mipChainRow(
+				(Uint8 *)chain[level - 1]->pixels + (row * factory) * chain[level - 1]->pitch,
+				(Uint8 *)chain[level - 1]->pixels + (row * factory + factory - 1) * chain[level - 1]->pitch,
+				(Uint8 *)chain[level]->pixels + row * chain[level]->pitch,
+				chain[level]->w, bpp, (chain[level - 1]->w > 1) ? 2 : 1);
+		}
+	}
+
+	/*
+	* Unlock source surface 
+	*/
+	if (SDL_MUSTLOCK(rz_src)) {
+		SDL_UnlockSurface(rz_src);
+	}
+
+exitBuildMipChain:
+	/*
+	* Cleanup temp surface 
+	*/
+	if (src_converted == 1) {
+		SDL_FreeSurface(rz_src);
+	}
+
+	/* Check error state; maybe need to cleanup chain */
+	if (haveError == 1) {
+		freeMipChain(chain);
+		chain = NULL;
+		levels = 0;
+	}
+
+	if (numLevels != NULL) {
+		*numLevels = levels;
+	}
+
+	return (chain);
+}
+
+/*! 
+\brief Free a mipmap pyramid created by buildMipChain().
+
+\param chain The NULL terminated array of level surfaces; may be NULL.
+*/
+void freeMipChain(SDL_Surface **chain)
+{
+	int level;
+
+	if (chain == NULL) {
+		return;
+	}
+	for (level = 0; chain[level] != NULL; level++) {
+		SDL_FreeSurface(chain[level]);
+	}
+	free(chain);
+}
+
+/*!
+\brief Internal helper which inverts the matrix of a warp.
+
+\param m The 2x3 affine or 3x3 perspective matrix (row major).
+\param perspective Flag indicating 'm' is a 3x3 perspective matrix.
+\param inv Array receiving the inverted matrix (6 or 9 doubles).
+
+\returns 0 for success or -1 if the matrix is singular.
+*/
+static int _invertWarpMatrix(const double *m, int perspective, double *inv)
+{
+	double det;
+
+	if (!perspective) {
+		det = m[0] * m[4] - m[1] * m[3];
+		if (fabs(det) < 1e-12) {
+			return -1;
+		}
+		inv[0] = m[4] / det;
+		inv[1] = -m[1] / det;
+		inv[2] = (m[1] * m[5] - m[2] * m[4]) / det;
+		inv[3] = -m[3] / det;
+		inv[4] = m[0] / det;
+		inv[5] = (m[2] * m[3] - m[0] * m[5]) / det;
+		return 0;
+	}
+
+	det = m[0] * (m[4] * m[8] - m[5] * m[7]) 
+		- m[1] * (m[3] * m[8] - m[5] * m[6]) 
+		+ m[2] * (m[3] * m[7] - m[4] * m[6]);
+	if (fabs(det) < 1e-12) {
+		return -1;
+	}
+	inv[0] = (m[4] * m[8] - m[5] * m[7]) / det;
+	inv[1] = (m[2] * m[7] - m[1] * m[8]) / det;
+	inv[2] = (m[1] * m[5] - m[2] * m[4]) / det;
+	inv[3] = (m[5] * m[6] - m[3] * m[8]) / det;
+	inv[4] = (m[0] * m[8] - m[2] * m[6]) / det;
+	inv[5] = (m[2] * m[3] - m[0] * m[5]) / det;
+	inv[6] = (m[3] * m[7] - m[4] * m[6]) / det;
+	inv[7] = (m[1] * m[6] - m[0] * m[7]) / det;
+	inv[8] = (m[0] * m[4] - m[1] * m[3]) / det;
+	return 0;
+}
+
+/*!
+\brief Internal warper used by warpAffineSurface() and warpPerspectiveSurface().
+
+\param src The surface to warp (8 or 32 bit).
+\param dst The destination surface (same depth as the source).
+\param matrix The 2x3 affine or 3x3 perspective matrix mapping source to destination coordinates (row major).
+\param perspective Flag indicating 'matrix' is a 3x3 perspective matrix.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable.
+
+\returns 0 for success or -1 for error.
+*/
+static int _warpSurface(SDL_Surface * src, SDL_Surface * dst, const double *matrix, int perspective, int smooth)
+{
+	double inv[9];
+	int subpixel;
+
+	/*
+	* Sanity check 
+	*/
+	if ((src == NULL) || (dst == NULL) || (matrix == NULL)) {
+		SDL_SetError("NULL source or destination surface or matrix");
+		return -1;
+	}
+	if (((src->format->BitsPerPixel != 32) && (src->format->BitsPerPixel != 8)) ||
+		(src->format->BitsPerPixel != dst->format->BitsPerPixel)) {
+		SDL_SetError("Source and destination surfaces must both be 32 bit or 8 bit");
+		return -1;
+	}
+	if ((src->format->Rmask != dst->format->Rmask) || (src->format->Gmask != dst->format->Gmask) ||
+		(src->format->Bmask != dst->format->Bmask) || (src->format->Amask != dst->format->Amask)) {
+		SDL_SetError("Source and destination surfaces must have the same pixel format");
+		return -1;
+	}
+	if (_invertWarpMatrix(matrix, perspective, inv) < 0) {
+		SDL_SetError("Singular warp matrix");
+		return -1;
+	}
+
+	/*
+	* Lock surfaces 
+	*/
+	if (SDL_MUSTLOCK(src)) {
+		if (SDL_LockSurface(src) < 0) {
+			return -1;
+		}
+	}
+	if (SDL_MUSTLOCK(dst)) {
+		if (SDL_LockSurface(dst) < 0) {
+			if (SDL_MUSTLOCK(src)) {
+				SDL_UnlockSurface(src);
+			}
+			return -1;
+		}
+	}
+
+	/*
+	* Scan destination and map back into the source
+	*/
+	_transformSurfaceWarp(src, dst, inv, perspective, _smoothingFlags(smooth, &subpixel));
+
+	/*
+	* Unlock surfaces 
+	*/
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_UnlockSurface(dst);
+	}
+	if (SDL_MUSTLOCK(src)) {
+		SDL_UnlockSurface(src);
+	}
+
+	return 0;
+}
+
+/*!
+\brief Warps a surface into another surface using an affine transformation.
+
+Maps the 32bit or 8bit 'src' surface into the existing 'dst' surface with the 
+2x3 affine 'matrix' (row major), i.e. source pixel (x,y) ends up at destination 
+position (m[0]*x + m[1]*y + m[2], m[3]*x + m[4]*y + m[5]). Pixel centers are at 
+integer coordinates. Each destination pixel is mapped back into the source in 
+floating point, so arbitrary rotation, scaling, shearing and translation 
+(e.g. deskewing) is possible. Destination pixels which map outside the source are
+left untouched (32 bit) or set to the colorkey of the source (8 bit).
+Both surfaces must have the same depth and pixel format. If 'smooth' is set
+then 32bit destination pixels are bilinearly interpolated.
+
+\param src The surface to warp.
+\param dst The destination surface.
+\param matrix The 2x3 affine matrix mapping source to destination coordinates.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. Add SMOOTHING_PREMULTIPLIED or SMOOTHING_PREMULTIPLIED_OUTPUT for alpha weighted smoothing.
+
+\return 0 for success or -1 for error (including singular matrices).
+*/
+int warpAffineSurface(SDL_Surface * src, SDL_Surface * dst, const double matrix[6], int smooth)
+{
+	return _warpSurface(src, dst, matrix, 0, smooth);
+}
+
+/*!
+\brief Warps a surface into another surface using a perspective transformation.
+
+Maps the 32bit or 8bit 'src' surface into the existing 'dst' surface with the 
+3x3 homography 'matrix' (row major), i.e. source pixel (x,y) ends up at destination 
+position ((m[0]*x + m[1]*y + m[2]) / w, (m[3]*x + m[4]*y + m[5]) / w) with 
+w = m[6]*x + m[7]*y + m[8]. Pixel centers are at integer coordinates. Destination
+pixels which map outside the source (or behind the projection center) are left
+untouched (32 bit) or set to the colorkey of the source (8 bit).
+Both surfaces must have the same depth and pixel format. If 'smooth' is set
+then 32bit destination pixels are bilinearly interpolated.
+
+\param src The surface to warp.
+\param dst The destination surface.
+\param matrix The 3x3 homography mapping source to destination coordinates.
+\param smooth Antialiasing flag; set to SMOOTHING_ON to enable. Add SMOOTHING_PREMULTIPLIED or SMOOTHING_PREMULTIPLIED_OUTPUT for alpha weighted smoothing.
+
+\return 0 for success or -1 for error (including singular matrices).
+*/
+int warpPerspectiveSurface(SDL_Surface * src, SDL_Surface * dst, const double matrix[9], int smooth)
+{
+	return _warpSurface(src, dst, matrix, 1, smooth);
+}
@@ -1,6 +1,6 @@
 /*  
 
-SDL2_rotozoom.c: rotozoomer, zoomer and shrinker for 32bit or 8bit surfaces
+SDL2_rotozoom.c: rotozoomer, zoomer and shrinker for 32bit, 24bit, 16bit or 8bit surfaces
 
 Copyright (C) 2012-2014  Andreas Schiffler
 
@@ -55,6 +55,49 @@ extern "C" {
 	*/
 #define SMOOTHING_ON		1
 
+	/*!
+	\brief Use the floating point, subpixel-accurate transformer.
+
+	Can be combined with SMOOTHING_OFF or SMOOTHING_ON. Source positions are 
+	calculated per pixel from an affine matrix instead of being accumulated 
+	in 16.16 fixed point, which avoids drift on large surfaces.
+	*/
+#define SMOOTHING_SUBPIXEL	2
+
+	/*!
+	\brief Interpolate 32 bit RGBA surfaces with alpha weighted (premultiplied) smoothing.
+
+	Can be combined with SMOOTHING_ON. Colors of transparent pixels do not bleed
+	into the edges of the result; the output remains in straight (non-premultiplied) alpha.
+	*/
+#define SMOOTHING_PREMULTIPLIED	4
+
+	/*!
+	\brief Like SMOOTHING_PREMULTIPLIED, but leave the result premultiplied by alpha.
+
+	Can be combined with SMOOTHING_ON. Intended for rendering with a premultiplied blend mode.
+	*/
+#define SMOOTHING_PREMULTIPLIED_OUTPUT	8
+
+	/* ---- Structures */
+
+	/*!
+	\brief Callback receiving the destination rows of a streaming zoom.
+
+	'row' points to 'width' 32 bit pixels of destination row 'y'; it is only valid during the call.
+	*/
+	typedef void (*ZoomStreamRowCallback)(void *userdata, int y, const void *row, int width);
+
+	/*!
+	\brief Opaque state of a streaming zoom (see zoomStreamCreate()).
+	*/
+	typedef struct ZoomStream ZoomStream;
+
+	/*!
+	\brief Opaque state of a rotozoom cache (see rotozoomCacheCreate()).
+	*/
+	typedef struct RotozoomCache RotozoomCache;
+
 	/* ---- Function Prototypes */
 
 #ifdef _MSC_VER
@@ -74,6 +117,9 @@ extern "C" {
 
 	Rotozoom functions
 
+	Changed: zoomed or keyed 16bit and 24bit surfaces are returned in their own format,
+	earlier versions returned them as 32bit RGBA surfaces.
+
 	*/
 
 	SDL2_ROTOZOOM_SCOPE SDL_Surface *rotozoomSurface(SDL_Surface * src, double angle, double zoom, int smooth);
@@ -91,22 +137,64 @@ extern "C" {
 
 	/* 
 
+	Rotozoom cache functions
+
+	*/
+
+	SDL2_ROTOZOOM_SCOPE RotozoomCache *rotozoomCacheCreate(size_t maxbytes, int anglesteps);
+
+	SDL2_ROTOZOOM_SCOPE SDL_Surface *rotozoomCacheGet
+		(RotozoomCache * cache, SDL_Surface * src, double angle, double zoomx, double zoomy, int smooth);
+
+	SDL2_ROTOZOOM_SCOPE void rotozoomCacheInvalidate(RotozoomCache * cache, SDL_Surface * src);
+
+	SDL2_ROTOZOOM_SCOPE void rotozoomCacheFree(RotozoomCache * cache);
+
+	/* 
+
+	Texture streaming functions
+
+	*/
+
+	SDL2_ROTOZOOM_SCOPE int rotozoomSurfaceXYToTexture
+		(SDL_Surface * src, double angle, double zoomx, double zoomy, int smooth, 
+		SDL_Texture * texture, SDL_Rect * dstrect);
+
+	/* 
+
 	Zooming functions
 
+	Changed: 16bit and 24bit surfaces are returned in their own format,
+	earlier versions returned them as 32bit RGBA surfaces.
+
 	*/
 
 	SDL2_ROTOZOOM_SCOPE SDL_Surface *zoomSurface(SDL_Surface * src, double zoomx, double zoomy, int smooth);
 
 	SDL2_ROTOZOOM_SCOPE void zoomSurfaceSize(int width, int height, double zoomx, double zoomy, int *dstwidth, int *dstheight);
 
+	SDL2_ROTOZOOM_SCOPE ZoomStream *zoomStreamCreate(int srcwidth, int srcheight, int dstwidth, int dstheight, int smooth,
+		ZoomStreamRowCallback callback, void *userdata);
+
+	SDL2_ROTOZOOM_SCOPE int zoomStreamPushRows(ZoomStream * stream, const void *pixels, int pitch, int numrows);
+
+	SDL2_ROTOZOOM_SCOPE void zoomStreamFree(ZoomStream * stream);
+
 	/* 
 
 	Shrinking functions
 
+	Changed: 16bit and 24bit surfaces are returned in their own format,
+	earlier versions returned them as 32bit RGBA surfaces.
+
 	*/     
 
 	SDL2_ROTOZOOM_SCOPE SDL_Surface *shrinkSurface(SDL_Surface * src, int factorx, int factory);
 
+	SDL2_ROTOZOOM_SCOPE SDL_Surface **buildMipChain(SDL_Surface * src, int *numLevels);
+
+	SDL2_ROTOZOOM_SCOPE void freeMipChain(SDL_Surface ** chain);
+
 	/* 
 
 	Specialized rotation functions
@@ -115,6 +203,28 @@ extern "C" {
 
 	SDL2_ROTOZOOM_SCOPE SDL_Surface* rotateSurface90Degrees(SDL_Surface* src, int numClockwiseTurns);
 
+	/* 
+
+	In-place flipping functions
+
+	*/
+
+	SDL2_ROTOZOOM_SCOPE int flipSurfaceHorizontal(SDL_Surface* surface);
+
+	SDL2_ROTOZOOM_SCOPE int flipSurfaceVertical(SDL_Surface* surface);
+
+	SDL2_ROTOZOOM_SCOPE int rotateSurface180Degrees(SDL_Surface* surface);
+
+	/* 
+
+	Warping functions
+
+	*/
+
+	SDL2_ROTOZOOM_SCOPE int warpAffineSurface(SDL_Surface * src, SDL_Surface * dst, const double matrix[6], int smooth);
+
+	SDL2_ROTOZOOM_SCOPE int warpPerspectiveSurface(SDL_Surface * src, SDL_Surface * dst, const double matrix[9], int smooth);
+
 	/* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
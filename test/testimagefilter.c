@@ -105,6 +105,32 @@ void print_line()
 	printf ("------------------------------------------------------------------------\n\n\n");
 }
 
+/* Compares the rectangle x1..x2-1, y1..y2-1 of a padded 2D result with the packed result; 
+   all other bytes of the padded image (including the padding) must still be 0 */
+void print_compare_2d(char *label, unsigned char *img, int pitch, int height, unsigned char *packed, int width, 
+					  int x1, int y1, int x2, int y2)
+{
+	int x, y, bad = 0, outside = 0;
+
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < pitch; x++) {
+			if ((x >= x1) && (x < x2) && (y >= y1) && (y < y2)) {
+				if (img[y * pitch + x] != packed[y * width + x]) bad++;
+			} else if (img[y * pitch + x] != 0) {
+				outside++;
+			}
+		}
+	}
+	printf ("%s: ", label);
+	total_count++;
+	if ((bad == 0) && (outside == 0)) {
+		printf ("OK\n");
+		ok_count++;
+	} else {
+		printf ("ERROR (%d bytes differ from the packed call, %d bytes outside the rect written)\n", bad, outside);
+	}
+}
+
 /* ----------- main ---------- */
 
 int main(int argc, char *argv[])
@@ -363,6 +389,871 @@ int main(int argc, char *argv[])
 		print_line();
         }
 
+        {
+		Uint32 start;
+		int i, ok;
+		char call[1024];
+		SDL_snprintf(call, 1024, "NormalizeLinear(40,200,10,250)");
+
+		setup_src(src1, src2);
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterNormalizeLinear(src1, dstm, SRC_SIZE, 40,200, 10,250);
+		print_result(TEST_MMX, call, src1, NULL, dstm);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterNormalizeLinear(t1, d, size, 40,200, 10,250);
+		}
+		printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterNormalizeLinear(src1, dstc, SRC_SIZE, 40,200, 10,250);
+		print_result(TEST_C, call, src1, NULL, dstc);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterNormalizeLinear(t1, d, size, 40,200, 10,250);
+		}
+		printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		/* A gain of 1.5, rounded to nearest and saturated */
+		ok = 1;
+		for (i = 0; i < SRC_SIZE; i++) {
+			int v = (src1[i] >= 40) ? 10 + (3 * (src1[i] - 40) + 1) / 2 : 10 - (3 * (40 - src1[i])) / 2;
+			if (v < 0) v = 0;
+			if (v > 255) v = 255;
+			if (dstc[i] != v) ok = 0;
+		}
+		total_count++;
+		if ((bcmp(dstm, dstc, SRC_SIZE)==0) && (ok)) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+        }
+
+        {
+		int i, ok;
+		char call[1024];
+		unsigned char ramp[256], rampm[256], rampc[256];
+		SDL_snprintf(call, 1024, "NormalizeLinear(0,255, 64,192)");
+
+		setup_src(src1, src2);
+		for (i = 0; i < 256; i++) ramp[i] = i;
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterNormalizeLinear(src1, dstm, SRC_SIZE, 0,255, 64,192);
+		print_result(TEST_MMX, call, src1, NULL, dstm);
+		SDL_imageFilterNormalizeLinear(ramp, rampm, 256, 0,255, 64,192);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterNormalizeLinear(src1, dstc, SRC_SIZE, 0,255, 64,192);
+		print_result(TEST_C, call, src1, NULL, dstc);
+		SDL_imageFilterNormalizeLinear(ramp, rampc, 256, 0,255, 64,192);
+
+		/* A gain of 128/255 below 1, rounded to nearest: 0 maps to 64 and 255 to 192 */
+		ok = 1;
+		for (i = 0; i < 256; i++) {
+			int v = 64 + (256 * i + 255) / 510;
+			if (rampc[i] != v) ok = 0;
+		}
+		total_count++;
+		if ((bcmp(dstm, dstc, SRC_SIZE)==0) && (bcmp(rampm, rampc, 256)==0) && (ok)) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+        }
+
+        {
+		int i, ok;
+		char call[1024];
+		unsigned char ramp[256], rampm[256], rampc[256];
+		SDL_snprintf(call, 1024, "NormalizeLinear(50,150, 200,0)");
+
+		setup_src(src1, src2);
+		for (i = 0; i < 256; i++) ramp[i] = i;
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterNormalizeLinear(src1, dstm, SRC_SIZE, 50,150, 200,0);
+		print_result(TEST_MMX, call, src1, NULL, dstm);
+		SDL_imageFilterNormalizeLinear(ramp, rampm, 256, 50,150, 200,0);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterNormalizeLinear(src1, dstc, SRC_SIZE, 50,150, 200,0);
+		print_result(TEST_C, call, src1, NULL, dstc);
+		SDL_imageFilterNormalizeLinear(ramp, rampc, 256, 50,150, 200,0);
+
+		/* A negative gain of -2 (Nmax < Nmin), saturated at both ends */
+		ok = 1;
+		for (i = 0; i < 256; i++) {
+			int v = 200 - 2 * (i - 50);
+			if (v < 0) v = 0;
+			if (v > 255) v = 255;
+			if (rampc[i] != v) ok = 0;
+		}
+		total_count++;
+		if ((bcmp(dstm, dstc, SRC_SIZE)==0) && (bcmp(rampm, rampc, 256)==0) && (ok)) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+        }
+
+        {
+		Uint32 start;
+		int i;
+		char call[1024];
+		unsigned char *tn = (unsigned char *)SDL_malloc(size), *dn = (unsigned char *)SDL_malloc(size);
+		SDL_snprintf(call, 1024, "NormalizeAuto(0,255)");
+
+		setup_src(src1, src2);
+		/* Large input limited to 40..199, so that it is actually stretched */
+		for (i = 0; i < size; i++) {
+			tn[i] = 40 + t1[i] % 160;
+		}
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterNormalizeAuto(src1, dstm, SRC_SIZE, 0,255);
+		print_result(TEST_MMX, call, src1, NULL, dstm);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterNormalizeAuto(tn, dn, size, 0,255);
+		}
+		printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterNormalizeAuto(src1, dstc, SRC_SIZE, 0,255);
+		print_result(TEST_C, call, src1, NULL, dstc);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterNormalizeAuto(tn, d, size, 0,255);
+		}
+		printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		total_count++;
+		if ((bcmp(dstm, dstc, SRC_SIZE)==0) && (bcmp(dn, d, size)==0)) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		SDL_free(tn);
+		SDL_free(dn);
+		print_line();
+        }
+
+	/* Statistics */
+        {
+		Uint32 start;
+		int i;
+		unsigned int histm[256], histc[256];
+		unsigned char minm, maxm, minc, maxc;
+		Uint64 summ, sumc;
+		double meanm, varm, meanc, varc;
+
+		SDL_imageFilterMMXon();
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterHistogram(t1, size, histm);
+			SDL_imageFilterMinMax(t1, size, &minm, &maxm);
+			SDL_imageFilterSum(t1, size, &summ);
+			SDL_imageFilterMeanVariance(t1, size, &meanm, &varm);
+		}
+		printf("MMX Histogram+MinMax+Sum+MeanVariance %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+		printf("    min %u max %u sum %.0f mean %.3f variance %.3f\n", minm, maxm, (double)summ, meanm, varm);
+
+		SDL_imageFilterMMXoff();
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterHistogram(t1, size, histc);
+			SDL_imageFilterMinMax(t1, size, &minc, &maxc);
+			SDL_imageFilterSum(t1, size, &sumc);
+			SDL_imageFilterMeanVariance(t1, size, &meanc, &varc);
+		}
+		printf(" C  Histogram+MinMax+Sum+MeanVariance %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+		printf("    min %u max %u sum %.0f mean %.3f variance %.3f\n", minc, maxc, (double)sumc, meanc, varc);
+
+		total_count++;
+		if ((memcmp(histm, histc, sizeof(histm))==0) && (minm == minc) && (maxm == maxc) && (summ == sumc) &&
+			(meanm == meanc) && (varm == varc)) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+        }
+
+
+	/* Convolution functions */
+        {
+#undef FUNC
+#define FUNC(f, n, c) { #f, SDL_imageFilter ## f, n, c }
+		struct func {
+			char* name;
+			int (*f)(unsigned char*, unsigned char*, int, int, signed short*, unsigned char);
+			int n;
+			unsigned char arg;
+		};
+		struct func funcs[] = {
+			FUNC(ConvolveKernel3x3Divide,     3, 9),
+			FUNC(ConvolveKernel5x5Divide,     5, 9),
+			FUNC(ConvolveKernel7x7Divide,     7, 9),
+			FUNC(ConvolveKernel9x9Divide,     9, 9),
+			FUNC(ConvolveKernel3x3ShiftRight, 3, 2),
+			FUNC(ConvolveKernel5x5ShiftRight, 5, 2),
+			FUNC(ConvolveKernel7x7ShiftRight, 7, 2),
+			FUNC(ConvolveKernel9x9ShiftRight, 9, 2),
+		};
+		/* Kernel rows are padded to 4, 8 or 12 words; only the center 3x3 is set */
+		signed short kernel[9*12];
+		unsigned char img[SRC_SIZE*SRC_SIZE], imgm[SRC_SIZE*SRC_SIZE], imgc[SRC_SIZE*SRC_SIZE];
+		unsigned char *row = &img[(SRC_SIZE/2)*SRC_SIZE];
+		
+		int k;
+		for (k = 0; k < sizeof(funcs)/sizeof(struct func); k++) {
+			Uint32 start;
+			int i, x, y, stride;
+			char call[1024];
+			SDL_snprintf(call, 1024, "%s(%u)", funcs[k].name, funcs[k].arg);
+			
+			stride = (funcs[k].n + 3) & ~3;
+			memset(kernel, 0, sizeof(kernel));
+			for (y = -1; y <= 1; y++) {
+				for (x = -1; x <= 1; x++) {
+					kernel[(funcs[k].n/2 + y)*stride + funcs[k].n/2 + x] = 1;
+				}
+			}
+			for (i = 0; i < SRC_SIZE*SRC_SIZE; i++) img[i] = rand();
+			memset(imgm, 0, sizeof(imgm));
+			memset(imgc, 0, sizeof(imgc));
+
+			SDL_imageFilterMMXon();
+			funcs[k].f(img, imgm, SRC_SIZE, SRC_SIZE, kernel, funcs[k].arg);
+			print_result(TEST_MMX, call, row, NULL, &imgm[(SRC_SIZE/2)*SRC_SIZE]);
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				funcs[k].f(t1, d, size/1024, 1024, kernel, funcs[k].arg);
+			}
+			printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+			
+			SDL_imageFilterMMXoff();
+			funcs[k].f(img, imgc, SRC_SIZE, SRC_SIZE, kernel, funcs[k].arg);
+			print_result(TEST_C, call, row, NULL, &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				funcs[k].f(t1, d, size/1024, 1024, kernel, funcs[k].arg);
+			}
+			printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+			
+			print_compare(&imgm[(SRC_SIZE/2)*SRC_SIZE], &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+			print_line();
+		}
+        }
+
+
+	/* Sobel functions */
+        {
+		Uint32 start;
+		int i, n;
+		char call[1024];
+		unsigned char img[SRC_SIZE*SRC_SIZE], imgm[SRC_SIZE*SRC_SIZE], imgc[SRC_SIZE*SRC_SIZE];
+		unsigned char *row = &img[(SRC_SIZE/2)*SRC_SIZE];
+
+		for (n = 0; n < 2; n++) {
+			if (n == 0) {
+				SDL_snprintf(call, 1024, "SobelX");
+			} else {
+				SDL_snprintf(call, 1024, "SobelXShiftRight(1)");
+			}
+
+			for (i = 0; i < SRC_SIZE*SRC_SIZE; i++) img[i] = rand();
+			memset(imgm, 0, sizeof(imgm));
+			memset(imgc, 0, sizeof(imgc));
+
+			SDL_imageFilterMMXon();
+			if (n == 0) SDL_imageFilterSobelX(img, imgm, SRC_SIZE, SRC_SIZE);
+			else SDL_imageFilterSobelXShiftRight(img, imgm, SRC_SIZE, SRC_SIZE, 1);
+			print_result(TEST_MMX, call, row, NULL, &imgm[(SRC_SIZE/2)*SRC_SIZE]);
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				if (n == 0) SDL_imageFilterSobelX(t1, d, size/1024, 1024);
+				else SDL_imageFilterSobelXShiftRight(t1, d, size/1024, 1024, 1);
+			}
+			printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+			SDL_imageFilterMMXoff();
+			if (n == 0) SDL_imageFilterSobelX(img, imgc, SRC_SIZE, SRC_SIZE);
+			else SDL_imageFilterSobelXShiftRight(img, imgc, SRC_SIZE, SRC_SIZE, 1);
+			print_result(TEST_C, call, row, NULL, &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				if (n == 0) SDL_imageFilterSobelX(t1, d, size/1024, 1024);
+				else SDL_imageFilterSobelXShiftRight(t1, d, size/1024, 1024, 1);
+			}
+			printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+			print_compare(&imgm[(SRC_SIZE/2)*SRC_SIZE], &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+			print_line();
+		}
+        }
+
+	/* Sobel gradient */
+        {
+		Uint32 start;
+		int i, norm;
+		char call[1024];
+		unsigned char img[SRC_SIZE*SRC_SIZE], imgm[SRC_SIZE*SRC_SIZE], imgc[SRC_SIZE*SRC_SIZE];
+		unsigned char dirm[SRC_SIZE*SRC_SIZE], dirc[SRC_SIZE*SRC_SIZE];
+		unsigned char *row = &img[(SRC_SIZE/2)*SRC_SIZE];
+		unsigned char *dt = (unsigned char *)SDL_malloc(size);
+
+		for (norm = SDL_IMAGEFILTER_SOBEL_L1; norm <= SDL_IMAGEFILTER_SOBEL_L2; norm++) {
+			SDL_snprintf(call, 1024, "Sobel(%s,dir)", (norm == SDL_IMAGEFILTER_SOBEL_L1) ? "L1" : "L2");
+
+			for (i = 0; i < SRC_SIZE*SRC_SIZE; i++) img[i] = rand();
+			memset(imgm, 0, sizeof(imgm));
+			memset(imgc, 0, sizeof(imgc));
+			memset(dirm, 0, sizeof(dirm));
+			memset(dirc, 0, sizeof(dirc));
+
+			SDL_imageFilterMMXon();
+			SDL_imageFilterSobel(img, imgm, dirm, SRC_SIZE, SRC_SIZE, norm, 1);
+			print_result(TEST_MMX, call, row, NULL, &imgm[(SRC_SIZE/2)*SRC_SIZE]);
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				SDL_imageFilterSobel(t1, d, dt, size/1024, 1024, norm, 1);
+			}
+			printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+			SDL_imageFilterMMXoff();
+			SDL_imageFilterSobel(img, imgc, dirc, SRC_SIZE, SRC_SIZE, norm, 1);
+			print_result(TEST_C, call, row, NULL, &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				SDL_imageFilterSobel(t1, d, dt, size/1024, 1024, norm, 1);
+			}
+			printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+			print_compare(&imgm[(SRC_SIZE/2)*SRC_SIZE], &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+			print_compare(&dirm[(SRC_SIZE/2)*SRC_SIZE], &dirc[(SRC_SIZE/2)*SRC_SIZE]);
+			print_line();
+		}
+
+		SDL_free(dt);
+        }
+
+
+	/* Separable convolution */
+        {
+		Uint32 start;
+		int i;
+		char call[1024];
+		unsigned char img[SRC_SIZE*SRC_SIZE], imgm[SRC_SIZE*SRC_SIZE], imgc[SRC_SIZE*SRC_SIZE];
+		unsigned char *row = &img[(SRC_SIZE/2)*SRC_SIZE];
+		signed short big[3] = { 32767, -32767, 32767 };
+		SDL_snprintf(call, 1024, "GaussianBlur(9)");
+
+		for (i = 0; i < SRC_SIZE*SRC_SIZE; i++) img[i] = rand();
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterGaussianBlur(img, imgm, SRC_SIZE, SRC_SIZE, 9, 0);
+		print_result(TEST_MMX, call, row, NULL, &imgm[(SRC_SIZE/2)*SRC_SIZE]);
+		start = SDL_GetTicks();
+		for (i = 0; i < 5; i++) {
+			SDL_imageFilterGaussianBlur(t1, d, size/1024, 1024, 9, 0);
+		}
+		printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterGaussianBlur(img, imgc, SRC_SIZE, SRC_SIZE, 9, 0);
+		print_result(TEST_C, call, row, NULL, &imgc[(SRC_SIZE/2)*SRC_SIZE]);
+		start = SDL_GetTicks();
+		for (i = 0; i < 5; i++) {
+			SDL_imageFilterGaussianBlur(t1, d, size/1024, 1024, 9, 0);
+		}
+		printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		print_compare(imgm, imgc);
+
+		/* Kernels whose sums may overflow 32 bits are rejected */
+		total_count++;
+		if (SDL_imageFilterConvolveSeparable(img, imgc, SRC_SIZE, SRC_SIZE, big, big, 3, 0) == -1) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR (overflowing kernel accepted)\n");
+		}
+		print_line();
+        }
+
+
+	/* Box blur and integral image */
+        {
+		Uint32 start;
+		int i, radius, result, bad;
+		unsigned int sum;
+		char call[1024];
+		unsigned char img[SRC_SIZE*SRC_SIZE], imgb[SRC_SIZE*SRC_SIZE], imgp[SRC_SIZE*(SRC_SIZE+5)];
+		unsigned int integral[(SRC_SIZE+1)*(SRC_SIZE+1)], integralp[(SRC_SIZE+1)*(SRC_SIZE+1)];
+		unsigned char *row = &img[(SRC_SIZE/2)*SRC_SIZE];
+		SDL_Rect rect;
+		SDL_snprintf(call, 1024, "BoxBlur(3)");
+
+		for (i = 0; i < SRC_SIZE*SRC_SIZE; i++) img[i] = rand();
+
+		SDL_imageFilterBoxBlur(img, imgb, SRC_SIZE, SRC_SIZE, 3);
+		print_result(TEST_C, call, row, NULL, &imgb[(SRC_SIZE/2)*SRC_SIZE]);
+		for (radius = 1; radius <= 31; radius = radius * 4 + 3) {
+			start = SDL_GetTicks();
+			for (i = 0; i < 5; i++) {
+				SDL_imageFilterBoxBlur(t1, d, size/1024, 1024, radius);
+			}
+			printf("radius %2d %dx%dk: %dms\n", radius, i, size/1024, SDL_GetTicks() - start);
+		}
+
+		/* The mean of the center window from the integral image must match the blur */
+		SDL_imageFilterIntegralImage(img, SRC_SIZE, integral, SRC_SIZE, SRC_SIZE);
+		rect.x = SRC_SIZE/2 - 3;
+		rect.y = SRC_SIZE/2 - 3;
+		rect.w = 7;
+		rect.h = 7;
+		result = SDL_imageFilterIntegralSum(integral, SRC_SIZE, SRC_SIZE, &rect, &sum);
+		printf("IntegralSum(7x7 center) = %u\n", sum);
+		total_count++;
+		if ((result == 0) && ((sum + 49/2) / 49 == imgb[(SRC_SIZE/2)*SRC_SIZE+SRC_SIZE/2])) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+
+		/* A padded source gives the same integral image; invalid input is rejected */
+		for (i = 0; i < SRC_SIZE*(SRC_SIZE+5); i++) {
+			imgp[i] = ((i % (SRC_SIZE+5)) < SRC_SIZE) ? img[(i / (SRC_SIZE+5)) * SRC_SIZE + i % (SRC_SIZE+5)] : 0xff;
+		}
+		memset(integralp, 0, sizeof(integralp));
+		result = SDL_imageFilterIntegralImage(imgp, SRC_SIZE+5, integralp, SRC_SIZE, SRC_SIZE);
+		printf("IntegralImage(pitch %d) and invalid input: ", SRC_SIZE+5);
+		total_count++;
+		bad = (result != 0) || (memcmp(integral, integralp, sizeof(integral)) != 0);
+		bad |= (SDL_imageFilterIntegralImage(NULL, SRC_SIZE, integralp, SRC_SIZE, SRC_SIZE) != -1);
+		bad |= (SDL_imageFilterIntegralImage(img, SRC_SIZE, NULL, SRC_SIZE, SRC_SIZE) != -1);
+		bad |= (SDL_imageFilterIntegralImage(img, SRC_SIZE - 1, integralp, SRC_SIZE, SRC_SIZE) != -1);
+		bad |= (SDL_imageFilterIntegralImage(img, SRC_SIZE, integralp, 0, SRC_SIZE) != -1);
+		bad |= (SDL_imageFilterIntegralImage(img, SRC_SIZE, integralp, SRC_SIZE, -1) != -1);
+		bad |= (SDL_imageFilterIntegralSum(NULL, SRC_SIZE, SRC_SIZE, &rect, &sum) != -1);
+		bad |= (SDL_imageFilterIntegralSum(integral, SRC_SIZE, SRC_SIZE, NULL, &sum) != -1);
+		bad |= (SDL_imageFilterIntegralSum(integral, SRC_SIZE, SRC_SIZE, &rect, NULL) != -1);
+		bad |= (SDL_imageFilterIntegralSum(integral, 0, SRC_SIZE, &rect, &sum) != -1);
+		bad |= (SDL_imageFilterIntegralSum(integral, SRC_SIZE, -1, &rect, &sum) != -1);
+		rect.x = SRC_SIZE - 6;
+		bad |= (SDL_imageFilterIntegralSum(integral, SRC_SIZE, SRC_SIZE, &rect, &sum) != -1);
+		rect.x = 0;
+		rect.w = -1;
+		bad |= (SDL_imageFilterIntegralSum(integral, SRC_SIZE, SRC_SIZE, &rect, &sum) != -1);
+		rect.w = SRC_SIZE;
+		rect.y = 0;
+		rect.h = SRC_SIZE;
+		bad |= (SDL_imageFilterIntegralSum(integral, SRC_SIZE, SRC_SIZE, &rect, &sum) != 0) || 
+			(sum != integral[(SRC_SIZE+1)*(SRC_SIZE+1) - 1]);
+		if (!bad) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+        }
+
+
+	/* Pipeline */
+        {
+		Uint32 start;
+		int i, mmx;
+		int length = 2 * 16384 + 1027;
+		char call[1024];
+		unsigned char *dt = (unsigned char *)SDL_malloc(size);
+		SDL_imageFilterPipeline *pipeline;
+		SDL_snprintf(call, 1024, "Pipeline(SubByte,MultByByte,ClipToRange,Binarize)");
+
+		pipeline = SDL_imageFilterPipelineCreate();
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_SUBBYTE, 10, 0, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_MULTBYBYTE, 3, 0, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_CLIPTORANGE, 20, 200, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_BINARIZEUSINGTHRESHOLD, 128, 0, 0, 0);
+
+		setup_src(src1, src2);
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterPipelineRun(pipeline, src1, dstm, SRC_SIZE);
+		print_result(TEST_MMX, call, src1, NULL, dstm);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterPipelineRun(pipeline, t1, d, size);
+		}
+		printf("MMX %dx%dk: %dms (fused)\n", i, size/1024, SDL_GetTicks() - start);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterSubByte(t1, d, size, 10);
+			SDL_imageFilterMultByByte(d, d, size, 3);
+			SDL_imageFilterClipToRange(d, d, size, 20, 200);
+			SDL_imageFilterBinarizeUsingThreshold(d, d, size, 128);
+		}
+		printf("MMX %dx%dk: %dms (separate)\n", i, size/1024, SDL_GetTicks() - start);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterSubByte(src1, dstc, SRC_SIZE, 10);
+		SDL_imageFilterMultByByte(dstc, dstc, SRC_SIZE, 3);
+		SDL_imageFilterClipToRange(dstc, dstc, SRC_SIZE, 20, 200);
+		SDL_imageFilterBinarizeUsingThreshold(dstc, dstc, SRC_SIZE, 128);
+		print_result(TEST_C, call, src1, NULL, dstc);
+
+		print_compare(dstm,dstc);
+
+		/* Fused and separate filters must match across the chunk boundaries of the pipeline */
+		for (mmx = 1; mmx >= 0; mmx--) {
+			if (mmx) SDL_imageFilterMMXon(); else SDL_imageFilterMMXoff();
+			memset(d, 0x55, length + 16);
+			memset(dt, 0x55, length + 16);
+			SDL_imageFilterPipelineRun(pipeline, t1 + 3, d, length);
+			SDL_imageFilterSubByte(t1 + 3, dt, length, 10);
+			SDL_imageFilterMultByByte(dt, dt, length, 3);
+			SDL_imageFilterClipToRange(dt, dt, length, 20, 200);
+			SDL_imageFilterBinarizeUsingThreshold(dt, dt, length, 128);
+			printf("%s Pipeline vs. separate filters, %d bytes: ", mmx ? "MMX" : " C ", length);
+			total_count++;
+			if (bcmp(d, dt, length + 16)==0) {
+				printf ("OK\n");
+				ok_count++;
+			} else {
+				printf ("ERROR\n");
+			}
+		}
+		print_line();
+
+		SDL_imageFilterPipelineFree(pipeline);
+		SDL_free(dt);
+        }
+
+	/* Lookup table */
+        {
+		Uint32 start;
+		int i;
+		char call[1024];
+		unsigned char lut[256];
+		unsigned char *dt = (unsigned char *)SDL_malloc(size);
+		SDL_imageFilterPipeline *pipeline;
+		SDL_snprintf(call, 1024, "LUT(SubByte,MultByByte,ClipToRange,Binarize)");
+
+		pipeline = SDL_imageFilterPipelineCreate();
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_SUBBYTE, 10, 0, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_MULTBYBYTE, 3, 0, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_CLIPTORANGE, 20, 200, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_BINARIZEUSINGTHRESHOLD, 128, 0, 0, 0);
+		SDL_imageFilterPipelineLUT(pipeline, lut);
+
+		setup_src(src1, src2);
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterLUT(src1, dstm, SRC_SIZE, lut);
+		print_result(TEST_MMX, call, src1, NULL, dstm);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterLUT(t1, d, size, lut);
+		}
+		printf("MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterLUT(src1, dstc, SRC_SIZE, lut);
+		print_result(TEST_C, call, src1, NULL, dstc);
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterLUT(t1, dt, size, lut);
+		}
+		printf(" C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+		print_compare(dstm,dstc);
+
+		/* The table must match the separate filters over the whole array */
+		SDL_imageFilterSubByte(t1, dt, size, 10);
+		SDL_imageFilterMultByByte(dt, dt, size, 3);
+		SDL_imageFilterClipToRange(dt, dt, size, 20, 200);
+		SDL_imageFilterBinarizeUsingThreshold(dt, dt, size, 128);
+		total_count++;
+		if (bcmp(d, dt, size)==0) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+
+		SDL_imageFilterPipelineFree(pipeline);
+		SDL_free(dt);
+        }
+
+
+	/* Surface channels */
+        {
+		Uint32 start;
+		int i, preserved;
+		unsigned char *dt = (unsigned char *)SDL_malloc(size);
+		SDL_Surface *s, *sm, *sc;
+
+		/* The arrays as ARGB8888 surfaces of 256x(size/1024) pixels */
+		s = SDL_CreateRGBSurfaceFrom(t1, 256, size/1024, 32, 1024, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+		sm = SDL_CreateRGBSurfaceFrom(d, 256, size/1024, 32, 1024, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+		sc = SDL_CreateRGBSurfaceFrom(dt, 256, size/1024, 32, 1024, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+
+		SDL_imageFilterMMXon();
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterSurfaceOp(s, sm, SDL_IMAGEFILTER_OP_MULTBYBYTE, 2, 1, 3, 0, SDL_IMAGEFILTER_PRESERVE_ALPHA);
+		}
+		printf("SurfaceOp(MultByByte 2,1,3) MMX %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		SDL_imageFilterMMXoff();
+		start = SDL_GetTicks();
+		for (i = 0; i < 50; i++) {
+			SDL_imageFilterSurfaceOp(s, sc, SDL_IMAGEFILTER_OP_MULTBYBYTE, 2, 1, 3, 0, SDL_IMAGEFILTER_PRESERVE_ALPHA);
+		}
+		printf("SurfaceOp(MultByByte 2,1,3)  C  %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		/* Both must agree, and the alpha bytes (offset 3 on little endian) must be copied */
+		preserved = 1;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+		for (i = 3; i < size; i += 4) {
+			if (d[i] != t1[i]) preserved = 0;
+		}
+#endif
+		total_count++;
+		if ((bcmp(d, dt, size)==0) && (preserved)) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+
+		SDL_FreeSurface(s);
+		SDL_FreeSurface(sm);
+		SDL_FreeSurface(sc);
+		SDL_free(dt);
+        }
+
+
+	/* Threads */
+        {
+		Uint32 start;
+		int i, threads;
+		unsigned char *dt = (unsigned char *)SDL_malloc(size);
+		signed short kernel[5*8];
+
+		for (i = 0; i < 5*8; i++) kernel[i] = ((i & 7) < 5) ? 1 : 0;
+		SDL_imageFilterMMXon();
+
+		SDL_imageFilterSetThreads(1);
+		start = SDL_GetTicks();
+		for (i = 0; i < 5; i++) {
+			SDL_imageFilterAdd(t1, t2, d, size);
+			SDL_imageFilterConvolveKernel5x5Divide(t1, d, size/1024, 1024, kernel, 25);
+		}
+		printf("Add+ConvolveKernel5x5Divide 1 thread    %dx%dk: %dms\n", i, size/1024, SDL_GetTicks() - start);
+
+		threads = SDL_imageFilterSetThreads(0);
+		start = SDL_GetTicks();
+		for (i = 0; i < 5; i++) {
+			SDL_imageFilterAdd(t1, t2, dt, size);
+			SDL_imageFilterConvolveKernel5x5Divide(t1, dt, size/1024, 1024, kernel, 25);
+		}
+		printf("Add+ConvolveKernel5x5Divide %d threads %dx%dk: %dms\n", threads, i, size/1024, SDL_GetTicks() - start);
+		SDL_imageFilterSetThreads(1);
+
+		total_count++;
+		if (bcmp(d, dt, size)==0) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR\n");
+		}
+		print_line();
+
+		SDL_free(dt);
+        }
+
+
+	/* Strided 2D images */
+        {
+		int y, bad;
+		char call[1024];
+		unsigned char img1[4*32], img2[4*32], imgd[4*32];
+		SDL_imageFilterImage s1 = { img1, 32, SRC_SIZE, 4 }, s2 = { img2, 32, SRC_SIZE, 4 }, sd = { imgd, 32, SRC_SIZE, 4 };
+		SDL_Rect rect = { 0, 2, SRC_SIZE, 1 };
+		SDL_snprintf(call, 1024, "Binary2D(Add, row 2)");
+
+		/* Row 2 of the padded images holds the test data */
+		setup_src(src1, src2);
+		memset(img1, 0, sizeof(img1));
+		memset(img2, 0, sizeof(img2));
+		memset(imgd, 0, sizeof(imgd));
+		memcpy(&img1[2*32], src1, SRC_SIZE);
+		memcpy(&img2[2*32], src2, SRC_SIZE);
+
+		SDL_imageFilterMMXon();
+		SDL_imageFilterBinary2D(SDL_imageFilterAdd, &s1, &s2, &sd, &rect);
+		print_result(TEST_MMX, call, src1, src2, &imgd[2*32]);
+
+		SDL_imageFilterMMXoff();
+		SDL_imageFilterAdd(src1, src2, dstc, SRC_SIZE);
+		print_result(TEST_C, call, src1, src2, dstc);
+
+		print_compare(&imgd[2*32], dstc);
+
+		/* The other rows and the padding of row 2 must be untouched */
+		bad = 0;
+		for (y = 0; y < 4*32; y++) {
+			if (((y < 2*32) || (y >= 2*32 + SRC_SIZE)) && (imgd[y] != 0)) bad++;
+		}
+		total_count++;
+		if (bad == 0) {
+			printf ("OK\n");
+			ok_count++;
+		} else {
+			printf ("ERROR (%d bytes outside the rect written)\n", bad);
+		}
+		print_line();
+        }
+
+
+	/* Strided 2D convolution, Sobel and pipeline */
+        {
+		int k, x, y, h, mmx, result;
+		char call[1024];
+		unsigned char imgs[13*40], imgd[13*40], packs[13*29], packd[13*29];
+		SDL_imageFilterImage s = { imgs, 40, 29, 13 }, sd = { imgd, 40, 29, 13 };
+		SDL_Rect rect = { 3, 2, 17, 8 };
+		signed short kernel3[3*4] = { 1, -2, 3, 0,  -1, 4, 2, 0,  2, -3, 1, 0 };
+		signed short kernel5[5*8];
+		SDL_imageFilterPipeline *pipeline;
+
+		/* Rows of 29 bytes padded to 40; the source padding must never be read */
+		for (y = 0; y < 13; y++) {
+			for (x = 0; x < 40; x++) {
+				imgs[y*40 + x] = (x < 29) ? rand() : 0xff;
+			}
+			memcpy(&packs[y*29], &imgs[y*40], 29);
+		}
+		for (k = 0; k < 5*8; k++) {
+			kernel5[k] = ((k % 8) < 5) ? (rand() % 7) - 3 : 0;
+		}
+		pipeline = SDL_imageFilterPipelineCreate();
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_SUBBYTE, 17, 0, 0, 0);
+		SDL_imageFilterPipelineAdd(pipeline, SDL_IMAGEFILTER_OP_MULTBYBYTE, 3, 0, 0, 0);
+
+		for (mmx = 1; mmx >= 0; mmx--) {
+			if (mmx) SDL_imageFilterMMXon(); else SDL_imageFilterMMXoff();
+			for (k = 0; k < 8; k++) {
+				memset(imgd, 0, sizeof(imgd));
+				memset(packd, 0, sizeof(packd));
+				switch (k / 2) {
+				case 0:
+					SDL_snprintf(call, 1024, "%s ConvolveKernel2D(3x3, Divisor 3) vs. ConvolveKernel3x3Divide, %s", 
+						mmx ? "MMX" : " C ", (k & 1) ? "whole image" : "rect");
+					h = 1;
+					result = SDL_imageFilterConvolveKernel2D(&s, &sd, (k & 1) ? NULL : &rect, kernel3, 3, 3, 0);
+					SDL_imageFilterConvolveKernel3x3Divide(packs, packd, 13, 29, kernel3, 3);
+					break;
+				case 1:
+					SDL_snprintf(call, 1024, "%s ConvolveKernel2D(5x5, NRightShift 2) vs. ConvolveKernel5x5ShiftRight, %s", 
+						mmx ? "MMX" : " C ", (k & 1) ? "whole image" : "rect");
+					h = 2;
+					result = SDL_imageFilterConvolveKernel2D(&s, &sd, (k & 1) ? NULL : &rect, kernel5, 5, 0, 2);
+					SDL_imageFilterConvolveKernel5x5ShiftRight(packs, packd, 13, 29, kernel5, 2);
+					break;
+				case 2:
+					SDL_snprintf(call, 1024, "%s SobelX2D(NRightShift 1) vs. SobelXShiftRight, %s", 
+						mmx ? "MMX" : " C ", (k & 1) ? "whole image" : "rect");
+					h = 1;
+					result = SDL_imageFilterSobelX2D(&s, &sd, (k & 1) ? NULL : &rect, 1);
+					SDL_imageFilterSobelXShiftRight(packs, packd, 13, 29, 1);
+					break;
+				default:
+					SDL_snprintf(call, 1024, "%s PipelineRun2D(SubByte, MultByByte) vs. PipelineRun, %s", 
+						mmx ? "MMX" : " C ", (k & 1) ? "whole image" : "rect");
+					h = 0;
+					result = SDL_imageFilterPipelineRun2D(pipeline, &s, &sd, (k & 1) ? NULL : &rect);
+					SDL_imageFilterPipelineRun(pipeline, packs, packd, 13*29);
+					break;
+				}
+				if (result != 0) {
+					total_count++;
+					printf ("%s: ERROR (returned %d)\n", call, result);
+				} else if (k & 1) {
+					print_compare_2d(call, imgd, 40, 13, packd, 29, h, h, 29 - h, 13 - h);
+				} else {
+					print_compare_2d(call, imgd, 40, 13, packd, 29, rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
+				}
+			}
+		}
+		SDL_imageFilterPipelineFree(pipeline);
+		print_line();
+        }
+
+
+	/* Convolution with saturating and negative weights against fixed results */
+        {
+		int k, x, mmx, result;
+		char call[1024];
+		unsigned char dst[3*8];
+		/* Large weights: the products wrap and the 16 bit column sums saturate, so a true sum above 255 can yield 0 */
+		unsigned char src1[3*8] = {
+			255, 255, 255, 255, 200, 100,  50,   0,
+			255, 255, 255, 255, 180,  90,  40,  10,
+			255, 255, 255, 255, 160,  80,  30,  20 };
+		signed short kernel1[3*4] = { 300, -110, 3, 0,  200, -110, 3, 0,  200, -110, 3, 0 };
+		unsigned char expected1[6] = { 0, 0, 0, 0, 255, 255 };
+		/* Sharpen: negative sums clamp to 0, the rest stays unclamped */
+		unsigned char src2[3*8] = {
+			 40,  40,  40, 200, 200, 200,  90,  10,
+			 40,  80,  40, 200, 120, 255,  90,  10,
+			 40,  40,  40, 200, 200, 200,  90,  10 };
+		signed short kernel2[3*4] = { 0, -1, 0, 0,  -1, 5, -1, 0,  0, -1, 0, 0 };
+		unsigned char expected2[6] = { 60, 0, 110, 0, 163, 1 };
+
+		for (mmx = 1; mmx >= 0; mmx--) {
+			if (mmx) SDL_imageFilterMMXon(); else SDL_imageFilterMMXoff();
+			for (k = 0; k < 2; k++) {
+				memset(dst, 0, sizeof(dst));
+				SDL_snprintf(call, 1024, "%s ConvolveKernel3x3ShiftRight(%s, NRightShift %d)", 
+					mmx ? "MMX" : " C ", k ? "sharpen" : "saturating weights", k ? 2 : 1);
+				result = k ? SDL_imageFilterConvolveKernel3x3ShiftRight(src2, dst, 3, 8, kernel2, 2)
+					: SDL_imageFilterConvolveKernel3x3ShiftRight(src1, dst, 3, 8, kernel1, 1);
+				total_count++;
+				if (result != 0) {
+					printf ("%s: ERROR (returned %d)\n", call, result);
+					continue;
+				}
+				for (x = 0; x < 6; x++) {
+					if (dst[8 + 1 + x] != (k ? expected2[x] : expected1[x])) break;
+				}
+				if (x == 6) {
+					ok_count++;
+					printf ("%s: OK\n", call);
+				} else {
+					printf ("%s: ERROR (pixel %d is %d, expected %d)\n", call, x + 1, dst[8 + 1 + x], 
+						k ? expected2[x] : expected1[x]);
+				}
+			}
+		}
+		print_line();
+        }
+
 
 	/* Uint functions */
 	/* Disabled, since broken *//* ??? */
@@ -338,6 +338,1449 @@ void RotatePicture90Degrees (SDL_Surface *picture)
 	SDL_Delay(1000);
 }
 
+void WarpPicture (SDL_Surface *picture, int smooth) 
+{
+	SDL_Surface *warp_picture;
+	SDL_Texture *warp_texture;
+	SDL_Rect dest;
+	int framecount, framemax;
+	double t, affine[6], perspective[9];
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+
+	SDL_Log("%s\n", messageText);
+
+	warp_picture = SDL_CreateRGBSurface(SDL_SWSURFACE, picture->w * 2, picture->h * 2, 32,
+		picture->format->Rmask, picture->format->Gmask, picture->format->Bmask, picture->format->Amask);
+	if (warp_picture == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create warp surface: %s\n", SDL_GetError());
+		return;
+	}
+
+	/* Shear (affine) and tilt (perspective) the picture */
+	framemax = 2*360;
+	for (framecount=0; framecount<framemax && !done; framecount++) {
+		while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+		SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+		SDL_RenderClear(renderer);
+		t = sin((double)framecount * M_PI / 180.0);
+
+		SDL_memset(warp_picture->pixels, 0, warp_picture->pitch * warp_picture->h);
+		if (framecount < 360) {
+			affine[0] = 1.0; affine[1] = 0.5 * t; affine[2] = picture->w / 2 - 0.25 * t * picture->h;
+			affine[3] = 0.25 * t; affine[4] = 1.0; affine[5] = picture->h / 2 - 0.125 * t * picture->w;
+			if (((framecount % 120)==0) || (delay>0)) {
+				SDL_Log("  Frame: %i   Affine: shear=%.2f\n", framecount, 0.5 * t);
+			}
+			warpAffineSurface(picture, warp_picture, affine, smooth);
+		} else {
+			perspective[0] = 1.0; perspective[1] = 0.0; perspective[2] = picture->w / 2;
+			perspective[3] = 0.0; perspective[4] = 1.0; perspective[5] = picture->h / 2;
+			perspective[6] = 0.002 * t; perspective[7] = 0.0; perspective[8] = 1.0;
+			if (((framecount % 120)==0) || (delay>0)) {
+				SDL_Log("  Frame: %i   Perspective: tilt=%.4f\n", framecount, 0.002 * t);
+			}
+			warpPerspectiveSurface(picture, warp_picture, perspective, smooth);
+		}
+
+		dest.x = (DEFAULT_WINDOW_WIDTH - warp_picture->w)/2;
+		dest.y = (DEFAULT_WINDOW_HEIGHT - warp_picture->h)/2;
+		dest.w = warp_picture->w;
+		dest.h = warp_picture->h;
+
+		/* Convert to texture and draw */
+		warp_texture = SDL_CreateTextureFromSurface(renderer, warp_picture);
+		if (!warp_texture) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+			break;
+		}
+		SDL_RenderCopy(renderer, warp_texture, NULL, &dest);
+		SDL_DestroyTexture(warp_texture);
+
+		stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+		/* Display */
+		SDL_RenderPresent(renderer);
+
+		/* Maybe delay */
+		if (delay>0) {
+			SDL_Delay(delay);
+		}
+	}
+
+	SDL_FreeSurface(warp_picture);
+
+	/* Pause for a sec */
+	SDL_Delay(1000);
+}
+
+void MipChainPicture (SDL_Surface *picture) 
+{
+	SDL_Surface **chain;
+	SDL_Texture *mip_texture;
+	SDL_Rect dest;
+	int level, levels;
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+
+	SDL_Log("%s\n", messageText);
+
+	if ((chain = buildMipChain(picture, &levels)) == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't build mip chain: %s\n", SDL_GetError());
+		return;
+	}
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+
+	/* Draw the levels next to each other */
+	dest.x = 8;
+	for (level = 0; level < levels; level++) {
+		SDL_Log("  Level: %i   Size: %ix%i\n", level, chain[level]->w, chain[level]->h);
+		dest.y = (DEFAULT_WINDOW_HEIGHT - chain[level]->h)/2;
+		dest.w = chain[level]->w;
+		dest.h = chain[level]->h;
+
+		/* Convert to texture and draw */
+		mip_texture = SDL_CreateTextureFromSurface(renderer, chain[level]);
+		if (!mip_texture) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+			break;
+		}
+		SDL_RenderCopy(renderer, mip_texture, NULL, &dest);
+		SDL_DestroyTexture(mip_texture);
+		dest.x += dest.w + 4;
+	}
+
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	freeMipChain(chain);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+void RotatePictureToTexture (SDL_Surface *picture, int smooth) 
+{
+	SDL_Texture *rotozoom_texture;
+	SDL_Rect src, dest;
+	int framecount, texwidth, texheight;
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+
+	SDL_Log("%s\n", messageText);
+
+	/* Streaming texture large enough for any angle */
+	rotozoomSurfaceSizeXY(picture->w, picture->h, 45.0, 1.0, 1.0, &texwidth, &texheight);
+	rotozoom_texture = SDL_CreateTexture(renderer, picture->format->format, SDL_TEXTUREACCESS_STREAMING, texwidth, texheight);
+	if (!rotozoom_texture) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+		return;
+	}
+	SDL_SetTextureBlendMode(rotozoom_texture, SDL_BLENDMODE_BLEND);
+
+	/* Rotate into the locked texture and display */
+	for (framecount=0; framecount<360 && !done; framecount++) {
+		while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+		SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+		SDL_RenderClear(renderer);
+		if (((framecount % 60)==0) || (delay>0)) {
+			SDL_Log("  Frame: %i   Rotate: angle=%i\n", framecount, framecount);
+		}
+		if (rotozoomSurfaceXYToTexture(picture, (double)framecount, 1.0, 1.0, smooth, rotozoom_texture, &src) == 0) {
+			dest.x = (DEFAULT_WINDOW_WIDTH - src.w)/2;
+			dest.y = (DEFAULT_WINDOW_HEIGHT - src.h)/2;
+			dest.w = src.w;
+			dest.h = src.h;
+			SDL_RenderCopy(renderer, rotozoom_texture, &src, &dest);
+		} else {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't rotate image into texture: %s\n", SDL_GetError());
+		}
+
+		stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+		/* Display */
+		SDL_RenderPresent(renderer);
+
+		/* Maybe delay */
+		if (delay>0) {
+			SDL_Delay(delay);
+		}
+	}
+
+	SDL_DestroyTexture(rotozoom_texture);
+
+	/* Pause for a sec */
+	SDL_Delay(1000);
+}
+
+/* Logs and draws the result line of a self-checking test at row y */
+void DrawCheckResult (SDL_Renderer *renderer, int y, const char *resultText, int errors)
+{
+	if (errors == 0) {
+		SDL_Log("%s\n", resultText);
+		stringRGBA(renderer, 8, y, resultText, 255, 255, 255, 255);
+	} else {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s\n", resultText);
+		stringRGBA(renderer, 8, y, resultText, 255, 0, 0, 255);
+	}
+}
+
+#define FLIPCHECK_HORIZONTAL	0
+#define FLIPCHECK_VERTICAL	1
+#define FLIPCHECK_ROTATE180	2
+
+/* Flips a random odd sized surface with padded rows in place and compares every
+   pixel with the expected mirror image; a second flip must restore the original
+   and the row padding must never be touched. Returns the number of errors. */
+int CheckFlipSurface (int bytesPerPixel, int mode)
+{
+	SDL_Surface *surface;
+	Uint8 *pixels, *original, *p, *q;
+	Uint32 rmask, gmask, bmask, amask;
+	int w = 37, h = 23, pitch, x, y, sx, sy, i, pass, result;
+	int errors = 0;
+
+	switch (bytesPerPixel) {
+	case 2:
+		rmask = 0xf800; gmask = 0x07e0; bmask = 0x001f; amask = 0;
+		break;
+	case 3:
+		rmask = 0xff0000; gmask = 0x00ff00; bmask = 0x0000ff; amask = 0;
+		break;
+	case 4:
+		rmask = 0x000000ff; gmask = 0x0000ff00; bmask = 0x00ff0000; amask = 0xff000000;
+		break;
+	default:
+		rmask = gmask = bmask = amask = 0;
+		break;
+	}
+
+	/* Rows are padded by 4 bytes beyond the 4 byte aligned width */
+	pitch = ((w * bytesPerPixel + 3) & ~3) + 4;
+	pixels = (Uint8 *)SDL_malloc(pitch * h);
+	original = (Uint8 *)SDL_malloc(pitch * h);
+	if ((pixels == NULL) || (original == NULL)) {
+		SDL_free(pixels);
+		SDL_free(original);
+		return 1;
+	}
+	for (i = 0; i < pitch * h; i++) {
+		pixels[i] = (Uint8)rand();
+	}
+	SDL_memcpy(original, pixels, pitch * h);
+	surface = SDL_CreateRGBSurfaceFrom(pixels, w, h, bytesPerPixel * 8, pitch, rmask, gmask, bmask, amask);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		SDL_free(pixels);
+		SDL_free(original);
+		return 1;
+	}
+
+	for (pass = 1; pass <= 2; pass++) {
+		switch (mode) {
+		case FLIPCHECK_HORIZONTAL:
+			result = flipSurfaceHorizontal(surface);
+			break;
+		case FLIPCHECK_VERTICAL:
+			result = flipSurfaceVertical(surface);
+			break;
+		default:
+			result = rotateSurface180Degrees(surface);
+			break;
+		}
+		if (result != 0) {
+			errors++;
+		}
+
+		for (y = 0; y < h; y++) {
+			for (x = 0; x < w; x++) {
+				sx = x;
+				sy = y;
+				if (pass == 1) {
+					if (mode != FLIPCHECK_VERTICAL) sx = w - 1 - x;
+					if (mode != FLIPCHECK_HORIZONTAL) sy = h - 1 - y;
+				}
+				p = pixels + y * pitch + x * bytesPerPixel;
+				q = original + sy * pitch + sx * bytesPerPixel;
+				if (SDL_memcmp(p, q, bytesPerPixel) != 0) {
+					errors++;
+				}
+			}
+			for (i = w * bytesPerPixel; i < pitch; i++) {
+				if (pixels[y * pitch + i] != original[y * pitch + i]) {
+					errors++;
+				}
+			}
+		}
+	}
+
+	SDL_FreeSurface(surface);
+	SDL_free(pixels);
+	SDL_free(original);
+
+	return errors;
+}
+
+void FlipSurfaceTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char *modeName[3] = { "flipSurfaceHorizontal", "flipSurfaceVertical", "rotateSurface180Degrees" };
+	char resultText[128];
+	int bytesPerPixel, mode, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check every function at every depth and print the results */
+	y = 24;
+	for (mode = FLIPCHECK_HORIZONTAL; mode <= FLIPCHECK_ROTATE180; mode++) {
+		for (bytesPerPixel = 1; bytesPerPixel <= 4; bytesPerPixel++) {
+			errors = CheckFlipSurface(bytesPerPixel, mode);
+			SDL_snprintf(resultText, 128, "  %s (%ibit): %s (%i errors)",
+				modeName[mode], bytesPerPixel * 8, (errors == 0) ? "OK" : "FAILED", errors);
+			DrawCheckResult(renderer, y, resultText, errors);
+			y += 12;
+		}
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Reads the raw value of pixel x,y of a 16, 24 or 32 bit surface */
+Uint32 GetCheckPixelValue (SDL_Surface *surface, int x, int y)
+{
+	Uint8 *p = (Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel;
+
+	switch (surface->format->BytesPerPixel) {
+	case 2:
+		return *(Uint16 *)p;
+	case 3:
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		return ((Uint32)p[0] << 16) | ((Uint32)p[1] << 8) | (Uint32)p[2];
+#else
+		return (Uint32)p[0] | ((Uint32)p[1] << 8) | ((Uint32)p[2] << 16);
+#endif
+	default:
+		return *(Uint32 *)p;
+	}
+}
+
+/* Reads pixel x,y of a 16, 24 or 32 bit surface as 8 bit RGBA channels */
+void GetCheckPixel (SDL_Surface *surface, int x, int y, Uint8 *c)
+{
+	SDL_GetRGBA(GetCheckPixelValue(surface, x, y), surface->format, &c[0], &c[1], &c[2], &c[3]);
+}
+
+/* Compares every pixel of 'result' with the 32 bit 'reference'; channels may differ by
+   'tolerance'. Where 'coverage' is transparent the raw pixel of 'result' must be 'key'
+   instead. Returns the number of differing pixels. */
+int CompareCheckSurfaces (SDL_Surface *result, SDL_Surface *reference, int tolerance, SDL_Surface *coverage, Uint32 key)
+{
+	Uint8 a[4], b[4];
+	int x, y, i;
+	int errors = 0;
+
+	if ((result == NULL) || (reference == NULL) || (result->w != reference->w) || (result->h != reference->h)) {
+		return 1;
+	}
+	for (y = 0; y < result->h; y++) {
+		for (x = 0; x < result->w; x++) {
+			if (coverage != NULL) {
+				GetCheckPixel(coverage, x, y, a);
+				if (a[3] == 0) {
+					if (GetCheckPixelValue(result, x, y) != key) {
+						errors++;
+					}
+					continue;
+				}
+			}
+			GetCheckPixel(result, x, y, a);
+			GetCheckPixel(reference, x, y, b);
+			for (i = 0; i < 4; i++) {
+				if (abs(a[i] - b[i]) > tolerance) {
+					errors++;
+					break;
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+/* Zooms, shrinks and rotates a random odd sized 16 or 24 bit surface in its own format
+   and compares the results with the same calls on a 32 bit RGBA copy; channels may differ
+   by twice the precision the packed format lacks. Unkeyed rotations must return 32 bit RGBA,
+   keyed ones the source format with the key in the uncovered corners. Returns the number
+   of errors. */
+int CheckPackedSurface (int bitsPerPixel, Uint32 rmask, Uint32 gmask, Uint32 bmask)
+{
+	SDL_Surface *surface, *surface32, *result, *reference;
+	Uint32 key, value;
+	int w = 37, h = 23, x, y, i, smooth, tolerance;
+	int errors = 0;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, bitsPerPixel, rmask, gmask, bmask, 0);
+	surface32 = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if ((surface == NULL) || (surface32 == NULL)) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		if (surface) SDL_FreeSurface(surface);
+		if (surface32) SDL_FreeSurface(surface32);
+		return 1;
+	}
+
+	/* Random pixels, but none equal to the colorkey */
+	key = (bitsPerPixel == 16) ? 0x1234 : 0x123456;
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w * surface->format->BytesPerPixel; x++) {
+			((Uint8 *)surface->pixels)[y * surface->pitch + x] = (Uint8)rand();
+		}
+		for (x = 0; x < w; x++) {
+			if (GetCheckPixelValue(surface, x, y) == key) {
+				((Uint8 *)surface->pixels)[y * surface->pitch + x * surface->format->BytesPerPixel] ^= 1;
+			}
+		}
+	}
+	SDL_BlitSurface(surface, NULL, surface32, NULL);
+	/* The packed result and the conversion to 32bit may both be off by the lost precision */
+	tolerance = 2 * ((1 << surface->format->Rloss) - 1);
+
+	for (smooth = SMOOTHING_OFF; smooth <= SMOOTHING_ON; smooth++) {
+		/* Zoom and flip */
+		result = zoomSurface(surface, 1.7, -0.6, smooth);
+		reference = zoomSurface(surface32, 1.7, -0.6, smooth);
+		if ((result == NULL) || (result->format->BitsPerPixel != bitsPerPixel)) {
+			errors++;
+		} else {
+			errors += CompareCheckSurfaces(result, reference, tolerance, NULL, 0);
+		}
+		if (result) SDL_FreeSurface(result);
+		if (reference) SDL_FreeSurface(reference);
+
+		/* Unkeyed rotation */
+		result = rotozoomSurfaceXY(surface, 33.0, -1.3, -0.8, smooth);
+		reference = rotozoomSurfaceXY(surface32, 33.0, -1.3, -0.8, smooth);
+		if ((result == NULL) || (result->format->BitsPerPixel != 32)) {
+			errors++;
+		} else {
+			errors += CompareCheckSurfaces(result, reference, tolerance, NULL, 0);
+		}
+		if (result) SDL_FreeSurface(result);
+
+		/* Keyed rotation; the unkeyed reference marks the uncovered corners */
+		SDL_SetColorKey(surface, SDL_TRUE, key);
+		result = rotozoomSurfaceXY(surface, 33.0, -1.3, -0.8, smooth);
+		SDL_SetColorKey(surface, SDL_FALSE, 0);
+		if ((result == NULL) || (result->format->BitsPerPixel != bitsPerPixel) || 
+			(SDL_GetColorKey(result, &value) != 0) || (value != key)) {
+			errors++;
+		} else {
+			errors += CompareCheckSurfaces(result, reference, tolerance, reference, key);
+		}
+		if (result) SDL_FreeSurface(result);
+		if (reference) SDL_FreeSurface(reference);
+	}
+
+	/* Shrink with box sizes that do not divide the surface */
+	for (i = 2; i <= 4; i++) {
+		result = shrinkSurface(surface, i, 5 - i);
+		reference = shrinkSurface(surface32, i, 5 - i);
+		if ((result == NULL) || (result->format->BitsPerPixel != bitsPerPixel)) {
+			errors++;
+		} else {
+			errors += CompareCheckSurfaces(result, reference, tolerance, NULL, 0);
+		}
+		if (result) SDL_FreeSurface(result);
+		if (reference) SDL_FreeSurface(reference);
+	}
+
+	SDL_FreeSurface(surface);
+	SDL_FreeSurface(surface32);
+
+	return errors;
+}
+
+void PackedSurfaceTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char *formatName[3] = { "RGB565", "RGB555", "RGB24" };
+	int bitsPerPixel[3] = { 16, 16, 24 };
+	Uint32 masks[3][3] = { { 0xf800, 0x07e0, 0x001f }, { 0x7c00, 0x03e0, 0x001f }, { 0xff0000, 0x00ff00, 0x0000ff } };
+	char resultText[128];
+	int format, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check every packed format and print the results */
+	y = 24;
+	for (format = 0; format < 3; format++) {
+		errors = CheckPackedSurface(bitsPerPixel[format], masks[format][0], masks[format][1], masks[format][2]);
+		SDL_snprintf(resultText, 128, "  %s native vs. 32bit RGBA: %s (%i errors)",
+			formatName[format], (errors == 0) ? "OK" : "FAILED", errors);
+		DrawCheckResult(renderer, y, resultText, errors);
+		y += 12;
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Rotozooms a random surface into a streaming texture of a software renderer, which
+   keeps the locked pixels, and compares every row of the locked area (using the lock
+   pitch) with the surface returned by rotozoomSurfaceXY(). The texture is filled with
+   garbage before each call. Packed surfaces are keyed; their unkeyed rotation must be
+   rejected. Returns the number of errors. */
+int CheckRotateToTexture (int bitsPerPixel)
+{
+	SDL_Surface *target, *surface, *reference;
+	SDL_Renderer *renderer;
+	SDL_Texture *texture;
+	SDL_Rect rect;
+	Uint8 *pixels;
+	Uint32 rmask, gmask, bmask, amask, key;
+	double angle[3] = { 0.0, 33.0, -120.0 };
+	double zoom[3][2] = { { 1.5, 1.2 }, { -0.7, 2.0 }, { 2.2, -2.2 } };
+	int w = 41, h = 23, size = 160, pitch, x, y, a, z, smooth, bytesPerPixel;
+	int errors = 0;
+
+	switch (bitsPerPixel) {
+	case 16:
+		rmask = 0xf800; gmask = 0x07e0; bmask = 0x001f; amask = 0;
+		key = 0x1234;
+		break;
+	case 24:
+		rmask = 0xff0000; gmask = 0x00ff00; bmask = 0x0000ff; amask = 0;
+		key = 0x123456;
+		break;
+	default:
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		rmask = 0xff000000; gmask = 0x00ff0000; bmask = 0x0000ff00; amask = 0x000000ff;
+#else
+		rmask = 0x000000ff; gmask = 0x0000ff00; bmask = 0x00ff0000; amask = 0xff000000;
+#endif
+		key = 0;
+		break;
+	}
+	bytesPerPixel = bitsPerPixel / 8;
+
+	target = SDL_CreateRGBSurface(SDL_SWSURFACE, 16, 16, 32, rmask, gmask, bmask, amask);
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, bitsPerPixel, rmask, gmask, bmask, amask);
+	renderer = (target) ? SDL_CreateSoftwareRenderer(target) : NULL;
+	texture = ((renderer) && (surface)) ? SDL_CreateTexture(renderer, surface->format->format, SDL_TEXTUREACCESS_STREAMING, size, size) : NULL;
+	if (texture == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+		errors++;
+		goto cleanup;
+	}
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w * bytesPerPixel; x++) {
+			((Uint8 *)surface->pixels)[y * surface->pitch + x] = (Uint8)rand();
+		}
+	}
+
+	/* Unkeyed packed rotations are returned as 32bit RGBA and must be rejected */
+	if (bytesPerPixel < 4) {
+		if (rotozoomSurfaceXYToTexture(surface, 33.0, 1.0, 1.0, SMOOTHING_ON, texture, &rect) != -1) {
+			errors++;
+		}
+		SDL_SetColorKey(surface, SDL_TRUE, key);
+	}
+
+	for (a = 0; a < 3; a++) {
+		for (z = 0; z < 3; z++) {
+			for (smooth = SMOOTHING_OFF; smooth <= SMOOTHING_ON; smooth++) {
+				if (SDL_LockTexture(texture, NULL, (void **)&pixels, &pitch) < 0) {
+					errors++;
+					continue;
+				}
+				SDL_memset(pixels, 0xcd, pitch * size);
+				SDL_UnlockTexture(texture);
+
+				if (rotozoomSurfaceXYToTexture(surface, angle[a], zoom[z][0], zoom[z][1], smooth, texture, &rect) != 0) {
+					errors++;
+					continue;
+				}
+				reference = rotozoomSurfaceXY(surface, angle[a], zoom[z][0], zoom[z][1], smooth);
+				if ((reference == NULL) || (reference->format->BytesPerPixel != bytesPerPixel) ||
+					(rect.x != 0) || (rect.y != 0) || (rect.w != reference->w) || (rect.h != reference->h)) {
+					errors++;
+				} else if (SDL_LockTexture(texture, &rect, (void **)&pixels, &pitch) < 0) {
+					errors++;
+				} else {
+					for (y = 0; y < rect.h; y++) {
+						if (SDL_memcmp(pixels + y * pitch, (Uint8 *)reference->pixels + y * reference->pitch, rect.w * bytesPerPixel) != 0) {
+							errors++;
+						}
+					}
+					SDL_UnlockTexture(texture);
+				}
+				if (reference) SDL_FreeSurface(reference);
+			}
+		}
+	}
+
+cleanup:
+	if (texture) SDL_DestroyTexture(texture);
+	if (renderer) SDL_DestroyRenderer(renderer);
+	if (surface) SDL_FreeSurface(surface);
+	if (target) SDL_FreeSurface(target);
+
+	return errors;
+}
+
+void RotateToTextureTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char resultText[128];
+	int bitsPerPixel, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check 16bit and 24bit keyed and 32bit surfaces and print the results */
+	y = 24;
+	for (bitsPerPixel = 16; bitsPerPixel <= 32; bitsPerPixel += 8) {
+		errors = CheckRotateToTexture(bitsPerPixel);
+		SDL_snprintf(resultText, 128, "  rotozoomSurfaceXYToTexture (%ibit%s): %s (%i errors)",
+			bitsPerPixel, (bitsPerPixel < 32) ? ", keyed" : "", (errors == 0) ? "OK" : "FAILED", errors);
+		DrawCheckResult(renderer, y, resultText, errors);
+		y += 12;
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Checks the floating point transformer (SMOOTHING_SUBPIXEL) on a random 32 bit surface:
+   angle 0 and zoom 1 must reproduce the source exactly, with and without smoothing; 
+   zoom 0.5 samples every destination pixel half way between four source pixels, so the
+   result must be their average (within the rounding of the interpolation). Returns the 
+   number of errors. */
+int CheckSubpixelTransform (void)
+{
+	SDL_Surface *surface, *result;
+	Uint8 *p, *q;
+	int w = 38, h = 24, x, y, i, smooth, sum;
+	int errors = 0;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		return 1;
+	}
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w * 4; x++) {
+			((Uint8 *)surface->pixels)[y * surface->pitch + x] = (Uint8)rand();
+		}
+	}
+
+	/* Identity */
+	for (smooth = SMOOTHING_OFF; smooth <= SMOOTHING_ON; smooth++) {
+		result = rotozoomSurfaceXY(surface, 0.0, 1.0, 1.0, smooth | SMOOTHING_SUBPIXEL);
+		if ((result == NULL) || (result->w != w) || (result->h != h) || (result->format->BitsPerPixel != 32)) {
+			errors++;
+		} else {
+			for (y = 0; y < h; y++) {
+				if (SDL_memcmp((Uint8 *)result->pixels + y * result->pitch, (Uint8 *)surface->pixels + y * surface->pitch, w * 4) != 0) {
+					errors++;
+				}
+			}
+		}
+		if (result) SDL_FreeSurface(result);
+	}
+
+	/* Half pixel offset: destination pixel x,y samples source position 2x+0.5,2y+0.5 */
+	result = rotozoomSurfaceXY(surface, 0.0, 0.5, 0.5, SMOOTHING_ON | SMOOTHING_SUBPIXEL);
+	if ((result == NULL) || (result->w != w / 2) || (result->h != h / 2) || (result->format->BitsPerPixel != 32)) {
+		errors++;
+	} else {
+		for (y = 0; y < h / 2; y++) {
+			for (x = 0; x < w / 2; x++) {
+				p = (Uint8 *)result->pixels + y * result->pitch + x * 4;
+				q = (Uint8 *)surface->pixels + 2 * y * surface->pitch + 2 * x * 4;
+				for (i = 0; i < 4; i++) {
+					sum = q[i] + q[i + 4] + q[i + surface->pitch] + q[i + surface->pitch + 4];
+					if (abs(4 * p[i] - sum) > 4) {
+						errors++;
+						break;
+					}
+				}
+			}
+		}
+	}
+	if (result) SDL_FreeSurface(result);
+
+	SDL_FreeSurface(surface);
+
+	return errors;
+}
+
+void SubpixelTransformTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char resultText[128];
+	int errors;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check identity and half pixel interpolation and print the result */
+	errors = CheckSubpixelTransform();
+	SDL_snprintf(resultText, 128, "  SMOOTHING_SUBPIXEL identity and half pixel average (32bit): %s (%i errors)",
+		(errors == 0) ? "OK" : "FAILED", errors);
+	DrawCheckResult(renderer, 24, resultText, errors);
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Checks alpha weighted smoothing on a 2x2 32 bit surface of three opaque green pixels and
+   one fully transparent red pixel: zoomed and rotated with SMOOTHING_PREMULTIPLIED the red
+   must not bleed into the result and the green must stay saturated (straight alpha), or equal
+   to the alpha of the pixel (SMOOTHING_PREMULTIPLIED_OUTPUT). Returns the number of errors. */
+int CheckPremultipliedBleed (void)
+{
+	SDL_Surface *surface, *result;
+	Uint8 *p;
+	int flags[4] = {
+		SMOOTHING_ON | SMOOTHING_PREMULTIPLIED, 
+		SMOOTHING_ON | SMOOTHING_PREMULTIPLIED | SMOOTHING_SUBPIXEL, 
+		SMOOTHING_ON | SMOOTHING_PREMULTIPLIED_OUTPUT,
+		SMOOTHING_ON | SMOOTHING_PREMULTIPLIED_OUTPUT | SMOOTHING_SUBPIXEL };
+	int x, y, f, rotate, green;
+	int errors = 0;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, 2, 2, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		return 1;
+	}
+	for (y = 0; y < 2; y++) {
+		for (x = 0; x < 2; x++) {
+			p = (Uint8 *)surface->pixels + y * surface->pitch + x * 4;
+			if ((x == 1) && (y == 0)) {
+				p[0] = 255; p[1] = 0; p[2] = 0; p[3] = 0;
+			} else {
+				p[0] = 0; p[1] = 255; p[2] = 0; p[3] = 255;
+			}
+		}
+	}
+
+	for (f = 0; f < 4; f++) {
+		for (rotate = 0; rotate <= 1; rotate++) {
+			if (rotate) {
+				result = rotozoomSurface(surface, 30.0, 5.0, flags[f]);
+			} else {
+				result = zoomSurface(surface, 5.0, 5.0, flags[f]);
+			}
+			if ((result == NULL) || (result->format->BitsPerPixel != 32)) {
+				errors++;
+			} else {
+				for (y = 0; y < result->h; y++) {
+					for (x = 0; x < result->w; x++) {
+						p = (Uint8 *)result->pixels + y * result->pitch + x * 4;
+						if (p[3] == 0) {
+							continue;
+						}
+						green = (flags[f] & SMOOTHING_PREMULTIPLIED_OUTPUT) ? p[3] : 255;
+						if ((p[0] != 0) || (p[1] != green) || (p[2] != 0)) {
+							errors++;
+						}
+					}
+				}
+			}
+			if (result) SDL_FreeSurface(result);
+		}
+	}
+
+	SDL_FreeSurface(surface);
+
+	return errors;
+}
+
+void PremultipliedBleedTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char resultText[128];
+	int errors;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check that no transparent color bleeds into the result and print the result */
+	errors = CheckPremultipliedBleed();
+	SDL_snprintf(resultText, 128, "  SMOOTHING_PREMULTIPLIED transparent red next to opaque green (32bit): %s (%i errors)",
+		(errors == 0) ? "OK" : "FAILED", errors);
+	DrawCheckResult(renderer, 24, resultText, errors);
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Shrinks a random odd sized 32 bit surface whose rows start at unaligned addresses
+   with a pitch that is not a multiple of 16 and compares every pixel with the 
+   truncating box average of the generic shrinker, which the SSE2 fast paths for 
+   factors 2 and 4 must match exactly. Returns the number of errors. */
+int CheckShrinkSurface (int factor, int w, int h)
+{
+	SDL_Surface *surface, *result;
+	Uint8 *buffer, *pixels, *p, *q;
+	int pitch, x, y, dx, dy, c, sum;
+	int errors = 0;
+
+	/* Rows are padded by 4 bytes and the first row is 4 bytes off the allocation */
+	pitch = w * 4 + 4;
+	buffer = (Uint8 *)SDL_malloc(pitch * h + 4);
+	if (buffer == NULL) {
+		return 1;
+	}
+	pixels = buffer + 4;
+	for (x = 0; x < pitch * h; x++) {
+		pixels[x] = (Uint8)rand();
+	}
+	surface = SDL_CreateRGBSurfaceFrom(pixels, w, h, 32, pitch,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		SDL_free(buffer);
+		return 1;
+	}
+
+	result = shrinkSurface(surface, factor, factor);
+	if ((result == NULL) || (result->w != w / factor) || (result->h != h / factor) || (result->format->BitsPerPixel != 32)) {
+		errors++;
+	} else {
+		for (y = 0; y < result->h; y++) {
+			for (x = 0; x < result->w; x++) {
+				p = (Uint8 *)result->pixels + y * result->pitch + x * 4;
+				for (c = 0; c < 4; c++) {
+					sum = 0;
+					for (dy = 0; dy < factor; dy++) {
+						q = pixels + (y * factor + dy) * pitch + x * factor * 4 + c;
+						for (dx = 0; dx < factor; dx++) {
+							sum += q[dx * 4];
+						}
+					}
+					if (p[c] != sum / (factor * factor)) {
+						errors++;
+					}
+				}
+			}
+		}
+	}
+	if (result) SDL_FreeSurface(result);
+
+	SDL_FreeSurface(surface);
+	SDL_free(buffer);
+
+	return errors;
+}
+
+void ShrinkSurfaceTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	int factors[3] = { 2, 4, 3 };
+	int sizes[3][2] = { { 37, 23 }, { 9, 9 }, { 131, 17 } };
+	char resultText[128];
+	int i, j, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check each factor on several odd sizes and print the results */
+	y = 24;
+	for (i = 0; i < 3; i++) {
+		errors = 0;
+		for (j = 0; j < 3; j++) {
+			errors += CheckShrinkSurface(factors[i], sizes[j][0], sizes[j][1]);
+		}
+		SDL_snprintf(resultText, 128, "  shrinkSurface %ix%i vs. box average (32bit, odd sizes, unaligned pitch): %s (%i errors)",
+			factors[i], factors[i], (errors == 0) ? "OK" : "FAILED", errors);
+		DrawCheckResult(renderer, y, resultText, errors);
+		y += 12;
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Reference result and error count of a streaming zoom check */
+typedef struct {
+	SDL_Surface *reference;
+	int nextrow;
+	int errors;
+} ZoomStreamCheck;
+
+/* Compares each destination row of a streaming zoom with the reference surface */
+void ZoomStreamCheckRow (void *userdata, int y, const void *row, int width)
+{
+	ZoomStreamCheck *check = (ZoomStreamCheck *)userdata;
+
+	if ((y != check->nextrow) || (y >= check->reference->h) || (width != check->reference->w)) {
+		check->errors++;
+	} else if (SDL_memcmp(row, (Uint8 *)check->reference->pixels + y * check->reference->pitch, width * 4) != 0) {
+		check->errors++;
+	}
+	check->nextrow++;
+}
+
+/* Zooms a random 32 bit surface with zoomSurface and, for several band heights
+   including ones that do not divide the source height, pushes the same source 
+   band by band through a zoom stream: every streamed row must equal the row of 
+   zoomSurface and all rows must be emitted in order. Returns the number of errors. */
+int CheckZoomStream (double zoomx, double zoomy, int smooth)
+{
+	SDL_Surface *surface, *reference;
+	ZoomStream *stream;
+	ZoomStreamCheck check;
+	int bands[5] = { 1, 3, 7, 16, 41 };
+	int w = 53, h = 41, x, y, i, numrows;
+	int errors = 0;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		return 1;
+	}
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w * 4; x++) {
+			((Uint8 *)surface->pixels)[y * surface->pitch + x] = (Uint8)rand();
+		}
+	}
+
+	reference = zoomSurface(surface, zoomx, zoomy, smooth);
+	if (reference == NULL) {
+		SDL_FreeSurface(surface);
+		return 1;
+	}
+
+	for (i = 0; i < 5; i++) {
+		check.reference = reference;
+		check.nextrow = 0;
+		check.errors = 0;
+		stream = zoomStreamCreate(w, h, reference->w, reference->h, smooth, ZoomStreamCheckRow, &check);
+		if (stream == NULL) {
+			errors++;
+			continue;
+		}
+		for (y = 0; y < h; y += bands[i]) {
+			numrows = (y + bands[i] <= h) ? bands[i] : h - y;
+			if (zoomStreamPushRows(stream, (Uint8 *)surface->pixels + y * surface->pitch, surface->pitch, numrows) != 0) {
+				errors++;
+			}
+		}
+		zoomStreamFree(stream);
+		errors += check.errors;
+		if (check.nextrow != reference->h) {
+			errors++;
+		}
+	}
+
+	SDL_FreeSurface(reference);
+	SDL_FreeSurface(surface);
+
+	return errors;
+}
+
+void ZoomStreamTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char *smoothName[3] = { "SMOOTHING_OFF", "SMOOTHING_ON", "SMOOTHING_PREMULTIPLIED" };
+	int smooth[3] = { SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_ON | SMOOTHING_PREMULTIPLIED };
+	char resultText[128];
+	int i, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check enlarging and reducing zooms with each smoothing mode and print the results */
+	y = 24;
+	for (i = 0; i < 3; i++) {
+		errors = CheckZoomStream(2.3, 1.7, smooth[i]) + CheckZoomStream(0.6, 0.45, smooth[i]);
+		SDL_snprintf(resultText, 128, "  zoomStreamPushRows bands 1/3/7/16/41 vs. zoomSurface (32bit, %s): %s (%i errors)",
+			smoothName[i], (errors == 0) ? "OK" : "FAILED", errors);
+		DrawCheckResult(renderer, y, resultText, errors);
+		y += 12;
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Zooms an 8 bit surface with a grayscale palette holding the ramp 3*x + 2*y with
+   smoothing and compares every pixel with the bilinear reference, which for a ramp 
+   is the ramp itself at the source position of the pixel (first and last pixels of 
+   source and destination are aligned). The interpolation truncates, so results may
+   be up to 2 below the reference. Returns the number of errors. */
+int CheckGrayZoom (double zoomx, double zoomy)
+{
+	SDL_Surface *surface, *result;
+	int w = 41, h = 31, x, y, value;
+	double sx, sy, reference;
+	int errors = 0;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 8, 0, 0, 0, 0);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		return 1;
+	}
+	for (x = 0; x < 256; x++) {
+		surface->format->palette->colors[x].r = (Uint8)x;
+		surface->format->palette->colors[x].g = (Uint8)x;
+		surface->format->palette->colors[x].b = (Uint8)x;
+	}
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w; x++) {
+			((Uint8 *)surface->pixels)[y * surface->pitch + x] = (Uint8)(3 * x + 2 * y);
+		}
+	}
+
+	result = zoomSurface(surface, zoomx, zoomy, SMOOTHING_ON);
+	if ((result == NULL) || (result->format->BitsPerPixel != 8) || (result->w < 2) || (result->h < 2)) {
+		errors++;
+	} else {
+		for (y = 0; y < result->h; y++) {
+			sy = (double)y * (h - 1) / (result->h - 1);
+			if (zoomy < 0) sy = (h - 1) - sy;
+			for (x = 0; x < result->w; x++) {
+				sx = (double)x * (w - 1) / (result->w - 1);
+				if (zoomx < 0) sx = (w - 1) - sx;
+				reference = 3.0 * sx + 2.0 * sy;
+				value = ((Uint8 *)result->pixels)[y * result->pitch + x];
+				if ((value > reference + 0.5) || (value < reference - 2.5)) {
+					errors++;
+				}
+			}
+		}
+	}
+	if (result) SDL_FreeSurface(result);
+
+	SDL_FreeSurface(surface);
+
+	return errors;
+}
+
+void GrayZoomTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	double zooms[4][2] = { { 2.7, 1.9 }, { 0.6, 0.8 }, { -1.6, 2.2 }, { 1.3, -0.7 } };
+	char resultText[128];
+	int i, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check enlarging, reducing and flipping zooms and print the results */
+	y = 24;
+	for (i = 0; i < 4; i++) {
+		errors = CheckGrayZoom(zooms[i][0], zooms[i][1]);
+		SDL_snprintf(resultText, 128, "  zoomSurface %.1fx%.1f smoothed gray ramp vs. bilinear reference (8bit): %s (%i errors)",
+			zooms[i][0], zooms[i][1], (errors == 0) ? "OK" : "FAILED", errors);
+		DrawCheckResult(renderer, y, resultText, errors);
+		y += 12;
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Checks a rotozoom cache with results of equal size for a 32 bit surface: repeated
+   requests must return the cached surface, angles are quantized to the angle steps
+   (-0.4 and 359.6 degrees share the bucket of 0 degrees), a cache bounded to two 
+   results must evict the least recently used one, and invalidation must drop exactly 
+   the results of the given source. All returned references are held until the end, 
+   so a new result can never have the address of an earlier one. Returns the number 
+   of errors. */
+int CheckRotozoomCache (void)
+{
+	SDL_Surface *surface, *other, *result[16];
+	RotozoomCache *cache;
+	size_t bytes;
+	int n = 0, i;
+	int errors = 0;
+
+	surface = SDL_CreateRGBSurface(SDL_SWSURFACE, 32, 24, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+		0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+		);
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		return 1;
+	}
+	other = SDL_CreateRGBSurface(SDL_SWSURFACE, 32, 24, 32, surface->format->Rmask, surface->format->Gmask,
+		surface->format->Bmask, surface->format->Amask);
+	if (other == NULL) {
+		SDL_FreeSurface(surface);
+		return 1;
+	}
+
+	/* Size of one result; the smoothing flags change the key but not the size */
+	result[0] = rotozoomSurfaceXY(surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+	if (result[0] == NULL) {
+		SDL_FreeSurface(other);
+		SDL_FreeSurface(surface);
+		return 1;
+	}
+	bytes = (size_t)result[0]->pitch * result[0]->h;
+	SDL_FreeSurface(result[0]);
+
+	/* Hits and angle quantization (1 degree steps) */
+	cache = rotozoomCacheCreate(16 * bytes, 360);
+	if (cache == NULL) {
+		errors++;
+	} else {
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, -0.4, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, 359.6, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_ON);
+		result[n++] = rotozoomCacheGet(cache, other, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		if ((result[0] == NULL) || (result[1] != result[0]) || (result[2] != result[0]) || (result[3] != result[0])) {
+			errors++;
+		}
+		if ((result[4] == NULL) || (result[4] == result[0]) || (result[5] == NULL) || (result[5] == result[0])) {
+			errors++;
+		}
+
+		/* Invalidation drops the results of the source only */
+		rotozoomCacheInvalidate(cache, surface);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, other, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		if ((result[6] == NULL) || (result[6] == result[0]) || (result[7] != result[5])) {
+			errors++;
+		}
+		rotozoomCacheFree(cache);
+	}
+
+	/* LRU eviction with room for two results: A, B, A (hit), C evicts B */
+	cache = rotozoomCacheCreate(2 * bytes, 0);
+	if (cache == NULL) {
+		errors++;
+	} else {
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_ON);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_ON | SMOOTHING_PREMULTIPLIED);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_OFF);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_ON | SMOOTHING_PREMULTIPLIED);
+		result[n++] = rotozoomCacheGet(cache, surface, 0.0, 1.0, 1.0, SMOOTHING_ON);
+		if ((result[8] == NULL) || (result[10] != result[8]) || (result[12] != result[8]) || (result[13] != result[11])) {
+			errors++;
+		}
+		if ((result[14] == NULL) || (result[14] == result[9])) {
+			errors++;
+		}
+		rotozoomCacheFree(cache);
+	}
+
+	for (i = 0; i < n; i++) {
+		if (result[i]) SDL_FreeSurface(result[i]);
+	}
+	SDL_FreeSurface(other);
+	SDL_FreeSurface(surface);
+
+	return errors;
+}
+
+void RotozoomCacheTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char resultText[128];
+	int errors;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check hits, angle buckets, eviction and invalidation and print the result */
+	errors = CheckRotozoomCache();
+	SDL_snprintf(resultText, 128, "  rotozoomCacheGet hits, angle buckets, LRU eviction, invalidation (32bit): %s (%i errors)",
+		(errors == 0) ? "OK" : "FAILED", errors);
+	DrawCheckResult(renderer, 24, resultText, errors);
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
+/* Warps a random 8 or 32 bit surface with the identity and with an integer translation
+   by (5,-3), given as a 2x3 affine matrix or as a 3x3 perspective matrix (for the 
+   translation also scaled by 2, which is the same homography): every destination 
+   pixel must be an exact copy of its source pixel (transparent pixels are 0 with
+   alpha weighted smoothing). Destination pixels which map 
+   outside the source must be untouched (32 bit) or the colorkey (8 bit). Returns the 
+   number of errors. */
+int CheckWarpSurface (int bitsPerPixel, int perspective, int smooth)
+{
+	SDL_Surface *surface, *result;
+	double identity[9] = { 1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+	double translate[9] = { 1.0, 0.0, 5.0, 0.0, 1.0, -3.0, 0.0, 0.0, 1.0 };
+	double matrix[9], offset[3][2] = { { 0, 0 }, { 5, -3 }, { 5, -3 } };
+	Uint8 *p, *q;
+	int w = 37, h = 23, bpp = bitsPerPixel / 8, key = 7, x, y, sx, sy, i, pass, passes;
+	int errors = 0;
+
+	if (bitsPerPixel == 32) {
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32,
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff
+#else
+			0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000
+#endif
+			);
+	} else {
+		surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 8, 0, 0, 0, 0);
+	}
+	if (surface == NULL) {
+		SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+		return 1;
+	}
+	result = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, bitsPerPixel, surface->format->Rmask, surface->format->Gmask,
+		surface->format->Bmask, surface->format->Amask);
+	if (result == NULL) {
+		SDL_FreeSurface(surface);
+		return 1;
+	}
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w * bpp; x++) {
+			((Uint8 *)surface->pixels)[y * surface->pitch + x] = (Uint8)rand();
+		}
+	}
+	if (bitsPerPixel == 8) {
+		SDL_SetColorKey(surface, SDL_TRUE, key);
+	}
+
+	passes = (perspective) ? 3 : 2;
+	for (pass = 0; pass < passes; pass++) {
+		for (i = 0; i < 9; i++) {
+			matrix[i] = (pass == 0) ? identity[i] : translate[i];
+			if (pass == 2) matrix[i] *= 2.0;
+		}
+		SDL_memset(result->pixels, 0xa5, result->pitch * h);
+		if (perspective) {
+			i = warpPerspectiveSurface(surface, result, matrix, smooth);
+		} else {
+			i = warpAffineSurface(surface, result, matrix, smooth);
+		}
+		if (i != 0) {
+			errors++;
+			continue;
+		}
+		for (y = 0; y < h; y++) {
+			for (x = 0; x < w; x++) {
+				sx = x - (int)offset[pass][0];
+				sy = y - (int)offset[pass][1];
+				p = (Uint8 *)result->pixels + y * result->pitch + x * bpp;
+				if ((sx >= 0) && (sx < w) && (sy >= 0) && (sy < h)) {
+					q = (Uint8 *)surface->pixels + sy * surface->pitch + sx * bpp;
+					if ((bitsPerPixel == 32) && (smooth & SMOOTHING_PREMULTIPLIED) && (q[3] == 0)) {
+						/* Alpha weighted smoothing drops the color of transparent pixels */
+						if ((p[0] != 0) || (p[1] != 0) || (p[2] != 0) || (p[3] != 0)) {
+							errors++;
+						}
+					} else if (SDL_memcmp(p, q, bpp) != 0) {
+						errors++;
+					}
+				} else if (bitsPerPixel == 8) {
+					if (p[0] != key) {
+						errors++;
+					}
+				} else if ((p[0] != 0xa5) || (p[1] != 0xa5) || (p[2] != 0xa5) || (p[3] != 0xa5)) {
+					errors++;
+				}
+			}
+		}
+	}
+
+	SDL_FreeSurface(result);
+	SDL_FreeSurface(surface);
+
+	return errors;
+}
+
+void WarpSurfaceTests (void)
+{
+	SDL_Renderer *renderer = state->renderers[0];
+	SDL_Event event;
+	char *smoothName[3] = { "SMOOTHING_OFF", "SMOOTHING_ON", "SMOOTHING_PREMULTIPLIED" };
+	int smooth[3] = { SMOOTHING_OFF, SMOOTHING_ON, SMOOTHING_ON | SMOOTHING_PREMULTIPLIED };
+	char resultText[128];
+	int i, perspective, errors, y;
+
+	SDL_Log("%s\n", messageText);
+
+	while (SDL_PollEvent(&event)) SDLTest_CommonEvent(state, &event, &done);
+	SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+	SDL_RenderClear(renderer);
+	stringRGBA(renderer, 8, 8, messageText, 255, 255, 255, 255);
+
+	/* Check affine and perspective warps of both depths and print the results */
+	y = 24;
+	for (perspective = 0; perspective <= 1; perspective++) {
+		for (i = 0; i < 3; i++) {
+			errors = CheckWarpSurface(32, perspective, smooth[i]);
+			SDL_snprintf(resultText, 128, "  %s identity and translation (32bit, %s): %s (%i errors)",
+				(perspective) ? "warpPerspectiveSurface" : "warpAffineSurface", smoothName[i], 
+				(errors == 0) ? "OK" : "FAILED", errors);
+			DrawCheckResult(renderer, y, resultText, errors);
+			y += 12;
+		}
+		errors = CheckWarpSurface(8, perspective, SMOOTHING_OFF);
+		SDL_snprintf(resultText, 128, "  %s identity and translation (8bit): %s (%i errors)",
+			(perspective) ? "warpPerspectiveSurface" : "warpAffineSurface", (errors == 0) ? "OK" : "FAILED", errors);
+		DrawCheckResult(renderer, y, resultText, errors);
+		y += 12;
+	}
+
+	/* Display */
+	SDL_RenderPresent(renderer);
+
+	/* Pause for a few secs */
+	SDL_Delay(3000);
+	if (delay>0) {
+		SDL_Delay(delay);
+	}
+}
+
 #define ROTATE_OFF	0
 #define ROTATE_ON	1
 
@@ -813,6 +2256,226 @@ donerotate90:
 		if (end <= 25) return;
 	}
 
+	if (start<=26) {
+
+		/* Message */
+		SDL_Log("Loading 24bit image\n");
+
+		/* Load the image into a surface */
+		bmpfile = "sample24.bmp";
+		SDL_Log("Loading picture: %s\n", bmpfile);
+		picture = SDL_LoadBMP(bmpfile);
+		if ( picture == NULL ) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s\n", bmpfile, SDL_GetError());
+			return;
+		}
+
+		/* New source surface is 32bit with defined RGBA ordering */
+		SDL_Log("Converting 24bit image into 32bit RGBA surface ...\n");
+		picture_again = SDL_CreateRGBSurface(SDL_SWSURFACE, picture->w, picture->h, 32, rmask, gmask, bmask, amask);
+		if (picture_again == NULL) goto donewarp;
+		SDL_BlitSurface(picture,NULL,picture_again,NULL);
+
+		/* Excercise warp functions on 32bit RGBA */
+		SDL_snprintf(messageText, 1024, "26.  warp: Affine and perspective warp with interpolation (32bit)");
+		WarpPicture(picture_again, SMOOTHING_ON);
+
+donewarp:
+
+		/* Free the pictures */
+		SDL_FreeSurface(picture);
+		if (picture_again) SDL_FreeSurface(picture_again);
+		if (done) return;
+		if (end <= 26) return;
+	}
+
+	if (start<=27) {
+
+		/* Message */
+		SDL_Log("Loading 24bit image\n");
+
+		/* Load the image into a surface */
+		bmpfile = "sample24.bmp";
+		SDL_Log("Loading picture: %s\n", bmpfile);
+		picture = SDL_LoadBMP(bmpfile);
+		if ( picture == NULL ) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s\n", bmpfile, SDL_GetError());
+			return;
+		}
+
+		/* Excercise mip chain function; converts 24bit to 32bit RGBA on the fly */
+		SDL_snprintf(messageText, 1024, "27.  buildMipChain: Mipmap pyramid (24bit -> 32bit)");
+		MipChainPicture(picture);
+
+		/* Free the pictures */
+		SDL_FreeSurface(picture);
+		if (done) return;
+		if (end <= 27) return;
+	}
+
+	if (start<=28) {
+
+		/* Message */
+		SDL_Log("Loading 24bit image\n");
+
+		/* Load the image into a surface */
+		bmpfile = "sample24.bmp";
+		SDL_Log("Loading picture: %s\n", bmpfile);
+		picture = SDL_LoadBMP(bmpfile);
+		if ( picture == NULL ) {
+			SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s\n", bmpfile, SDL_GetError());
+			return;
+		}
+
+		/* New source surface is 32bit with defined RGBA ordering */
+		SDL_Log("Converting 24bit image into 32bit RGBA surface ...\n");
+		picture_again = SDL_CreateRGBSurface(SDL_SWSURFACE, picture->w, picture->h, 32, rmask, gmask, bmask, amask);
+		if (picture_again == NULL) goto donetexture;
+		SDL_BlitSurface(picture,NULL,picture_again,NULL);
+
+		/* Excercise rotozoom into streaming texture on 32bit RGBA */
+		SDL_snprintf(messageText, 1024, "28.  rotozoomSurfaceXYToTexture: Rotate into streaming texture with interpolation (32bit)");
+		RotatePictureToTexture(picture_again, SMOOTHING_ON);
+
+donetexture:
+
+		/* Free the pictures */
+		SDL_FreeSurface(picture);
+		if (picture_again) SDL_FreeSurface(picture_again);
+		if (done) return;
+		if (end <= 28) return;
+	}
+
+	if (start<=29) {
+
+		/* Message */
+		SDL_Log("In place flip tests ...\n");
+
+		/* Excercise in place flips on 8/16/24/32bit surfaces with odd size and padded pitch */
+		SDL_snprintf(messageText, 1024, "29.  flip: In place flips and 180 degree rotation (8/16/24/32bit)");
+		FlipSurfaceTests();
+
+		if (done) return;
+		if (end <= 29) return;
+	}
+
+	if (start<=30) {
+
+		/* Message */
+		SDL_Log("Packed surface tests ...\n");
+
+		/* Compare native 16/24bit zoom, shrink and rotation with the 32bit RGBA results */
+		SDL_snprintf(messageText, 1024, "30.  packed: Native 16/24bit transformations vs. 32bit RGBA");
+		PackedSurfaceTests();
+
+		if (done) return;
+		if (end <= 30) return;
+	}
+
+	if (start<=31) {
+
+		/* Message */
+		SDL_Log("Rotozoom into texture tests ...\n");
+
+		/* Compare the locked texture pixels with the rotozoomed surface */
+		SDL_snprintf(messageText, 1024, "31.  texture: rotozoomSurfaceXYToTexture vs. rotozoomSurfaceXY (16/24/32bit)");
+		RotateToTextureTests();
+
+		if (done) return;
+		if (end <= 31) return;
+	}
+
+	if (start<=32) {
+
+		/* Message */
+		SDL_Log("Subpixel transformer tests ...\n");
+
+		/* Check the floating point transformer against exact expected results */
+		SDL_snprintf(messageText, 1024, "32.  subpixel: SMOOTHING_SUBPIXEL identity and half pixel interpolation (32bit)");
+		SubpixelTransformTests();
+
+		if (done) return;
+		if (end <= 32) return;
+	}
+
+	if (start<=33) {
+
+		/* Message */
+		SDL_Log("Premultiplied smoothing tests ...\n");
+
+		/* Check that transparent pixels do not bleed their color */
+		SDL_snprintf(messageText, 1024, "33.  premultiplied: no color bleeding of transparent pixels (32bit)");
+		PremultipliedBleedTests();
+
+		if (done) return;
+		if (end <= 33) return;
+	}
+
+	if (start<=34) {
+
+		/* Message */
+		SDL_Log("Shrink surface tests ...\n");
+
+		/* Check the 2x2 and 4x4 shrink fast paths against the generic box average */
+		SDL_snprintf(messageText, 1024, "34.  shrink: shrinkSurface 2x2/4x4 fast paths vs. box average (32bit)");
+		ShrinkSurfaceTests();
+
+		if (done) return;
+		if (end <= 34) return;
+	}
+
+	if (start<=35) {
+
+		/* Message */
+		SDL_Log("Streaming zoom tests ...\n");
+
+		/* Check band by band zooming against zoomSurface */
+		SDL_snprintf(messageText, 1024, "35.  stream: zoomStreamPushRows in bands vs. zoomSurface (32bit)");
+		ZoomStreamTests();
+
+		if (done) return;
+		if (end <= 35) return;
+	}
+
+	if (start<=36) {
+
+		/* Message */
+		SDL_Log("Grayscale zoom tests ...\n");
+
+		/* Check smoothed 8 bit grayscale zooming against a bilinear reference */
+		SDL_snprintf(messageText, 1024, "36.  gray: smoothed zoomSurface of a gray ramp vs. bilinear reference (8bit)");
+		GrayZoomTests();
+
+		if (done) return;
+		if (end <= 36) return;
+	}
+
+	if (start<=37) {
+
+		/* Message */
+		SDL_Log("Rotozoom cache tests ...\n");
+
+		/* Check the behaviour of the rotozoom cache */
+		SDL_snprintf(messageText, 1024, "37.  cache: rotozoomCacheGet hits, angle buckets, eviction, invalidation (32bit)");
+		RotozoomCacheTests();
+
+		if (done) return;
+		if (end <= 37) return;
+	}
+
+	if (start<=38) {
+
+		/* Message */
+		SDL_Log("Warp surface tests ...\n");
+
+		/* Check that the identity and integer translations copy pixels exactly */
+		SDL_snprintf(messageText, 1024, "38.  warp: identity and integer translation reproduce the source (8/32bit)");
+		WarpSurfaceTests();
+
+		if (done) return;
+		if (end <= 38) return;
+	}
+
 	return;
 }
 
@@ -823,7 +2486,7 @@ int main(int argc, char *argv[])
 {
 	int i;
 	int testStart = 0;
-	int testEnd = 25;
+	int testEnd = 38;
 	SDL_Event event;
 	Uint32 then, now, frames;
 